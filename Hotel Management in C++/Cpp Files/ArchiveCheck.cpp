@@ -0,0 +1,57 @@
+#include "ArchiveCheck.h"
+#include "ReservationArchive.h"
+#include "Calendar.h"
+
+#include <iostream>
+#include <vector>
+#include <set>
+#include <filesystem>
+
+using namespace std;
+
+namespace {
+
+vector<Reservation> stays(int firstId, int count) {
+    vector<Reservation> list;
+    int day = Calendar::parseDay("2025-01-10");
+    for (int id = firstId; id < firstId + count; id++)
+        list.emplace_back(id, 1 + id % 7, day + id, day + id + 2, 101, 1, "Single", 2, 100.0);
+    return list;
+}
+
+bool expect(bool condition, const string& what) {
+    if (!condition) cout << "FAILED: " << what << "\n";
+    return condition;
+}
+
+} // namespace
+
+bool ArchiveCheck::run(const string& path) {
+    error_code ec;
+    filesystem::remove(path, ec);
+    ReservationArchive archive(path);
+
+    bool ok = expect(archive.append(ReservationArchive::encodeBlock(stays(1, 5))), "first append");
+    size_t intact = filesystem::file_size(path);
+    ok = expect(archive.append(ReservationArchive::encodeBlock(stays(6, 5))), "second append") && ok;
+
+    // Crash in the middle of the second block
+    filesystem::resize_file(path, intact + ReservationArchive::BlockHeaderSize + 3);
+    ok = expect(archive.validLength() == intact, "torn block detected") && ok;
+
+    ok = expect(archive.append(ReservationArchive::encodeBlock(stays(11, 5))), "append after the tear") && ok;
+
+    set<int> ids;
+    archive.forEach([&](const Reservation& r) { ids.insert(r.getId()); });
+    set<int> wanted;
+    for (int id = 1; id <= 5; id++) wanted.insert(id);
+    for (int id = 11; id <= 15; id++) wanted.insert(id);
+
+    ok = expect(ids == wanted, "stays of the intact blocks read back") && ok;
+    ok = expect(archive.maxId() == 15, "highest ID includes the new block") && ok;
+    ok = expect(archive.validLength() == filesystem::file_size(path), "no damaged bytes left") && ok;
+
+    filesystem::remove(path, ec);
+    cout << (ok ? "Archive check passed.\n" : "Archive check failed.\n");
+    return ok;
+}
@@ -0,0 +1,89 @@
+#include "AtomicFile.h"
+
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ================================================================
+//                  WRITE + FSYNC TEMP FILE
+// ================================================================
+bool AtomicFile::writeTemp(const string& path, const string& bytes) {
+    // Shard files live in a subdirectory that may not exist yet
+    filesystem::path dir = filesystem::path(path).parent_path();
+    if (!dir.empty()) {
+        error_code ec;
+        filesystem::create_directories(dir, ec);
+    }
+
+    FILE* f = fopen(tempPath(path).c_str(), "wb");
+    if (!f) return false;
+
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    ok = fflush(f) == 0 && ok;
+
+#ifdef _WIN32
+    ok = _commit(_fileno(f)) == 0 && ok;
+#else
+    ok = fsync(fileno(f)) == 0 && ok;
+#endif
+
+    ok = fclose(f) == 0 && ok;
+    return ok;
+}
+
+// ================================================================
+//                  ATOMIC RENAME
+// ================================================================
+bool AtomicFile::commit(const string& path) {
+    error_code ec;
+    filesystem::rename(tempPath(path), path, ec);
+    return !ec;
+}
+
+void AtomicFile::syncDirectory(const string& path) {
+#ifndef _WIN32
+    filesystem::path dir = filesystem::path(path).parent_path();
+    if (dir.empty()) dir = ".";
+
+    int fd = open(dir.string().c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+bool AtomicFile::write(const string& path, const string& bytes) {
+    if (!writeTemp(path, bytes) || !commit(path)) return false;
+    syncDirectory(path);
+    return true;
+}
+
+// ================================================================
+//                  DURABLE APPEND
+// ================================================================
+bool AtomicFile::append(const string& path, const string& bytes) {
+    FILE* f = fopen(path.c_str(), "ab");
+    if (!f) return false;
+
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    ok = fflush(f) == 0 && ok;
+
+#ifdef _WIN32
+    ok = _commit(_fileno(f)) == 0 && ok;
+#else
+    ok = fsync(fileno(f)) == 0 && ok;
+#endif
+
+    ok = fclose(f) == 0 && ok;
+    return ok;
+}
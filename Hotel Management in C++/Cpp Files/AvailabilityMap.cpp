@@ -0,0 +1,111 @@
+#include "AvailabilityMap.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AVAILABILITY_SSE2 1
+#endif
+
+using namespace std;
+
+// ================================================================
+//                  BUILD
+// ================================================================
+void AvailabilityMap::reset(const vector<Room>& rooms, int first, int horizon) {
+    firstDay = first;
+    horizonDays = horizon;
+    tables.clear();
+    slotBits.assign(rooms.size(), SlotBit());
+
+    for (size_t i = 0; i < rooms.size(); i++) {
+        auto it = find_if(tables.begin(), tables.end(),
+            [&](const TypeTable& t) { return t.type == rooms[i].getType(); });
+        if (it == tables.end()) {
+            tables.push_back(TypeTable());
+            tables.back().type = rooms[i].getType();
+            it = tables.end() - 1;
+        }
+
+        slotBits[i].table = static_cast<int>(it - tables.begin());
+        slotBits[i].bit = static_cast<int>(it->roomSlots.size());
+        it->roomSlots.push_back(static_cast<int>(i));
+    }
+
+    for (auto& t : tables) {
+        t.words = (t.roomSlots.size() + 63) / 64;
+        t.rows.assign(t.words * static_cast<size_t>(horizonDays), 0);
+    }
+}
+
+const AvailabilityMap::TypeTable* AvailabilityMap::findTable(const string& type) const {
+    for (auto& t : tables)
+        if (t.type == type) return &t;
+    return nullptr;
+}
+
+// ================================================================
+//                  BOOK / RELEASE
+// ================================================================
+void AvailabilityMap::setRange(int slot, int checkIn, int checkOut, bool booked) {
+    if (slot < 0 || static_cast<size_t>(slot) >= slotBits.size()) return;
+
+    TypeTable& t = tables[slotBits[slot].table];
+    size_t word = static_cast<size_t>(slotBits[slot].bit) / 64;
+    uint64_t mask = uint64_t(1) << (slotBits[slot].bit % 64);
+
+    int from = max(checkIn, firstDay);
+    int to = min(checkOut, firstDay + horizonDays);
+    for (int d = from; d < to; d++) {
+        uint64_t& w = t.rows[static_cast<size_t>(d - firstDay) * t.words + word];
+        w = booked ? (w | mask) : (w & ~mask);
+    }
+}
+
+bool AvailabilityMap::isBooked(int slot, int day) const {
+    if (slot < 0 || static_cast<size_t>(slot) >= slotBits.size()) return false;
+    if (day < firstDay || day >= firstDay + horizonDays) return false;
+
+    const TypeTable& t = tables[slotBits[slot].table];
+    size_t word = static_cast<size_t>(slotBits[slot].bit) / 64;
+    return (t.rows[static_cast<size_t>(day - firstDay) * t.words + word] >>
+        (slotBits[slot].bit % 64)) & 1;
+}
+
+// ================================================================
+//                  QUERY
+// ================================================================
+int AvailabilityMap::findFree(const string& type, int checkIn, int checkOut) const {
+    const TypeTable* t = findTable(type);
+    if (!t || t->words == 0 || !covers(checkIn, checkOut)) return -1;
+
+    // OR the day rows of the stay: a clear bit is a room free every night
+    vector<uint64_t> taken(t->rows.begin() + static_cast<size_t>(checkIn - firstDay) * t->words,
+        t->rows.begin() + static_cast<size_t>(checkIn - firstDay + 1) * t->words);
+
+    for (int d = checkIn + 1; d < checkOut; d++) {
+        const uint64_t* row = &t->rows[static_cast<size_t>(d - firstDay) * t->words];
+        size_t w = 0;
+#ifdef AVAILABILITY_SSE2
+        for (; w + 2 <= t->words; w += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&taken[w]));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + w));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&taken[w]), _mm_or_si128(a, b));
+        }
+#endif
+        for (; w < t->words; w++) taken[w] |= row[w];
+    }
+
+    size_t rooms = t->roomSlots.size();
+    for (size_t w = 0; w < t->words; w++) {
+        uint64_t freeBits = ~taken[w];
+        if (w == t->words - 1 && rooms % 64)
+            freeBits &= (uint64_t(1) << (rooms % 64)) - 1;   // bits past the last room
+        if (!freeBits) continue;
+
+        int bit = 0;
+        while (!((freeBits >> bit) & 1)) bit++;
+        return t->roomSlots[w * 64 + bit];
+    }
+    return -1;
+}
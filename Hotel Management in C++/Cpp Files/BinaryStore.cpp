@@ -0,0 +1,366 @@
+#include "BinaryStore.h"
+#include "AtomicFile.h"
+#include "Calendar.h"
+
+#include <fstream>
+#include <cstring>
+
+using namespace std;
+
+// ================================================================
+//                  LITTLE-ENDIAN WRITER / READER
+// ================================================================
+namespace {
+
+struct ByteWriter {
+    string& out;
+
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+
+    void u64(uint64_t v) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+
+    void i32(int v) { u32(static_cast<uint32_t>(v)); }
+
+    void f64(double v) {
+        uint64_t bits;
+        memcpy(&bits, &v, sizeof bits);
+        u64(bits);
+    }
+
+    // Length-prefixed string
+    void str(const string& s) {
+        u32(static_cast<uint32_t>(s.size()));
+        out.append(s);
+    }
+
+    // Fixed-width field, zero padded to width bytes (s fits)
+    void fixed(const string& s, size_t width) {
+        out.append(s);
+        out.append(width - s.size(), '\0');
+    }
+};
+
+struct ByteReader {
+    const char* p;
+    const char* end;
+
+    bool has(size_t n) const { return static_cast<size_t>(end - p) >= n; }
+    size_t left() const { return static_cast<size_t>(end - p); }
+
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        p += 4;
+        return v;
+    }
+
+    uint64_t u64() {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        p += 8;
+        return v;
+    }
+
+    int i32() { return static_cast<int>(u32()); }
+
+    double f64() {
+        uint64_t bits = u64();
+        double v;
+        memcpy(&v, &bits, sizeof v);
+        return v;
+    }
+
+    bool str(string& s) {
+        if (!has(4)) return false;
+        uint32_t n = u32();
+        if (!has(n)) return false;
+        s.assign(p, n);
+        p += n;
+        return true;
+    }
+
+    string fixed(size_t width) {
+        size_t n = strnlen(p, width);
+        string s(p, n);
+        p += width;
+        return s;
+    }
+};
+
+// Header + payload + checksum trailer around an encoded payload
+string wrap(uint32_t kind, uint32_t count, const string& payload) {
+    string out;
+    out.reserve(BinaryStore::HeaderSize + payload.size() + BinaryStore::TrailerSize);
+
+    ByteWriter w{ out };
+    out.append("HTLB", 4);
+    w.u32(BinaryStore::Version);
+    w.u32(kind);
+    w.u32(count);
+    w.u64(payload.size());
+    out.append(payload);
+    w.u64(BinaryStore::checksum(payload.data(), payload.size()));
+    return out;
+}
+
+// Validates the envelope and checksum and positions the reader on the payload
+bool unwrap(const char* bytes, size_t length, uint32_t kind, uint32_t& count, uint32_t& version,
+    ByteReader& payload) {
+    if (!BinaryStore::checkHeader(bytes, length, kind, count, version)) return false;
+
+    size_t size = length - BinaryStore::HeaderSize - BinaryStore::TrailerSize;
+    const char* data = bytes + BinaryStore::HeaderSize;
+    ByteReader trailer{ data + size, bytes + length };
+    if (trailer.u64() != BinaryStore::checksum(data, size)) return false;
+
+    payload = ByteReader{ data, data + size };
+    return true;
+}
+
+bool unwrap(const string& bytes, uint32_t kind, uint32_t& count, ByteReader& payload) {
+    uint32_t version;
+    return unwrap(bytes.data(), bytes.size(), kind, count, version, payload);
+}
+
+} // namespace
+
+// ================================================================
+//                  HEADER CHECK
+// ================================================================
+bool BinaryStore::checkHeader(const char* data, size_t size, uint32_t kind, uint32_t& count) {
+    uint32_t version;
+    return checkHeader(data, size, kind, count, version);
+}
+
+bool BinaryStore::checkHeader(const char* data, size_t size, uint32_t kind, uint32_t& count, uint32_t& version) {
+    if (size < HeaderSize + TrailerSize) return false;
+    if (memcmp(data, "HTLB", 4) != 0) return false;
+
+    ByteReader r{ data + 4, data + size };
+    version = r.u32();
+    if (version < MinVersion || version > Version) return false;
+    if (r.u32() != kind) return false;
+    count = r.u32();
+    uint64_t payloadSize = r.u64();
+
+    return size == HeaderSize + payloadSize + TrailerSize;
+}
+
+// ================================================================
+//                  CHECKSUM (FNV-1a 64)
+// ================================================================
+uint64_t BinaryStore::checksum(const char* data, size_t size) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// ================================================================
+//                  ENCODERS
+// ================================================================
+string BinaryStore::encodeCustomers(const vector<Customer>& customers) {
+    string payload;
+    ByteWriter w{ payload };
+
+    for (auto& c : customers) {
+        w.i32(c.getId());
+        w.i32(c.getTotalBookings());
+        w.str(c.getName());
+        w.str(c.getPhone());
+        w.str(c.getEmail());
+    }
+    return wrap(Customers, static_cast<uint32_t>(customers.size()), payload);
+}
+
+string BinaryStore::encodeReservations(const vector<Reservation>& reservations) {
+    string payload;
+    payload.reserve(reservations.size() * ReservationRecordSize);
+    ByteWriter w{ payload };
+
+    for (auto& r : reservations) {
+        if (r.getRoomType().size() > RoomTypeWidth) return string();
+
+        w.i32(r.getId());
+        w.i32(r.getCustomerId());
+        w.i32(r.getCheckInDay());
+        w.i32(r.getCheckOutDay());
+        w.i32(r.getRoomNumber());
+        w.i32(r.getFloor());
+        w.fixed(r.getRoomType(), RoomTypeWidth);
+        w.i32(r.getNights());
+        w.f64(r.getFinalPrice());
+    }
+    return wrap(Reservations, static_cast<uint32_t>(reservations.size()), payload);
+}
+
+string BinaryStore::encodeRooms(const vector<Room>& rooms) {
+    string payload;
+    ByteWriter w{ payload };
+
+    for (auto& r : rooms) {
+        w.i32(r.getRoomNumber());
+        w.i32(r.getFloor());
+        w.f64(r.getPrice());
+        w.str(r.getType());
+
+        w.u32(static_cast<uint32_t>(r.getComments().size()));
+        for (auto& c : r.getComments()) w.str(c);
+
+        w.u32(static_cast<uint32_t>(r.getReservationIds().size()));
+        for (int id : r.getReservationIds()) w.i32(id);
+    }
+    return wrap(Rooms, static_cast<uint32_t>(rooms.size()), payload);
+}
+
+// ================================================================
+//                  DECODERS
+// ================================================================
+bool BinaryStore::decodeCustomers(const string& bytes, vector<Customer>& out) {
+    uint32_t count;
+    ByteReader r{ nullptr, nullptr };
+    if (!unwrap(bytes, Customers, count, r)) return false;
+
+    // The count is not covered by the checksum: every customer takes at
+    // least 20 bytes (two ints, three string lengths)
+    if (count > r.left() / 20) return false;
+
+    out.reserve(out.size() + count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!r.has(8)) return false;
+        int id = r.i32();
+        int bookings = r.i32();
+
+        string name, phone, email;
+        if (!r.str(name) || !r.str(phone) || !r.str(email)) return false;
+
+        out.emplace_back(id, name, phone, email, bookings);
+    }
+    return r.left() == 0;
+}
+
+const BinaryStore::RecordLayout& BinaryStore::reservationLayout(uint32_t version) {
+    static const RecordLayout v1{ 56, 8, 18, 28, 32, 36, 44, 48, true };
+    static const RecordLayout v2{ ReservationRecordSize, 8, 12, 16, 20, 24, 32, 36, false };
+    return version == 1 ? v1 : v2;
+}
+
+Reservation BinaryStore::decodeReservationRecord(const char* record, const RecordLayout& layout) {
+    ByteReader r{ record, record + layout.size };
+
+    int id = r.i32();
+    int customerId = r.i32();
+    int in, out;
+    if (layout.textDates) {
+        in = Calendar::parseDay(r.fixed(10));
+        out = Calendar::parseDay(r.fixed(10));
+    }
+    else {
+        in = r.i32();
+        out = r.i32();
+    }
+    int roomNumber = r.i32();
+    int floor = r.i32();
+    string type = r.fixed(RoomTypeWidth);
+    int nights = r.i32();
+    double price = r.f64();
+
+    return Reservation(id, customerId, in, out, roomNumber, floor, type, nights, price);
+}
+
+bool BinaryStore::decodeReservations(const string& bytes, vector<Reservation>& out) {
+    return decodeReservations(bytes.data(), bytes.size(), out);
+}
+
+bool BinaryStore::decodeReservations(const char* data, size_t size, vector<Reservation>& out) {
+    uint32_t count, version;
+    ByteReader r{ nullptr, nullptr };
+    if (!unwrap(data, size, Reservations, count, version, r)) return false;
+
+    const RecordLayout& layout = reservationLayout(version);
+    if (r.left() != static_cast<size_t>(count) * layout.size) return false;
+
+    out.reserve(out.size() + count);
+    for (uint32_t i = 0; i < count; i++)
+        out.push_back(decodeReservationRecord(r.p + static_cast<size_t>(i) * layout.size, layout));
+
+    return true;
+}
+
+bool BinaryStore::decodeRooms(const string& bytes, vector<Room>& out) {
+    uint32_t count;
+    ByteReader r{ nullptr, nullptr };
+    if (!unwrap(bytes, Rooms, count, r)) return false;
+
+    // At least 28 bytes per room (number, floor, price, three lengths)
+    if (count > r.left() / 28) return false;
+
+    out.reserve(out.size() + count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!r.has(16)) return false;
+        int number = r.i32();
+        int floor = r.i32();
+        double price = r.f64();
+
+        string type;
+        if (!r.str(type)) return false;
+
+        Room room(number, floor, type, price);
+
+        if (!r.has(4)) return false;
+        uint32_t comments = r.u32();
+        for (uint32_t c = 0; c < comments; c++) {
+            string text;
+            if (!r.str(text)) return false;
+            room.addComment(text);
+        }
+
+        if (!r.has(4)) return false;
+        uint32_t ids = r.u32();
+        if (!r.has(static_cast<size_t>(ids) * 4)) return false;
+        for (uint32_t k = 0; k < ids; k++) room.addReservation(r.i32());
+
+        out.push_back(std::move(room));
+    }
+    return r.left() == 0;
+}
+
+// ================================================================
+//                  FILE I/O
+// ================================================================
+bool BinaryStore::readFile(const string& path, string& bytes) {
+    ifstream f(path, ios::binary);
+    if (!f.good()) return false;
+
+    f.seekg(0, ios::end);
+    bytes.resize(static_cast<size_t>(f.tellg()));
+    f.seekg(0, ios::beg);
+    f.read(&bytes[0], static_cast<streamsize>(bytes.size()));
+    return f.good() || f.eof();
+}
+
+bool BinaryStore::writeFile(const string& path, const string& bytes) {
+    return AtomicFile::write(path, bytes);
+}
+
+bool BinaryStore::isComplete(const string& path, uint32_t kind) {
+    ifstream f(path, ios::binary | ios::ate);
+    if (!f.good()) return false;
+
+    size_t size = static_cast<size_t>(f.tellg());
+    if (size < HeaderSize + TrailerSize) return false;
+
+    // checkHeader only looks at the first HeaderSize bytes and the size
+    char header[HeaderSize];
+    f.seekg(0, ios::beg);
+    if (!f.read(header, HeaderSize)) return false;
+
+    uint32_t count;
+    return checkHeader(header, size, kind, count);
+}
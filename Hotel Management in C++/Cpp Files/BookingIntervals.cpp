@@ -0,0 +1,48 @@
+#include "BookingIntervals.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// ================================================================
+//                  ADD / REMOVE
+// ================================================================
+void BookingIntervals::add(int checkIn, int checkOut, int reservationId) {
+    if (checkOut <= checkIn) return;   // empty stay blocks nothing
+
+    Booking b{ checkIn, checkOut, reservationId };
+    if (isFree(checkIn, checkOut)) bookings.emplace(checkIn, b);
+    else conflicts.push_back(b);
+}
+
+void BookingIntervals::remove(int checkIn, int reservationId) {
+    auto it = bookings.find(checkIn);
+    if (it != bookings.end() && it->second.reservationId == reservationId) {
+        bookings.erase(it);
+        return;
+    }
+
+    conflicts.erase(remove_if(conflicts.begin(), conflicts.end(),
+        [&](const Booking& b) { return b.reservationId == reservationId; }),
+        conflicts.end());
+}
+
+void BookingIntervals::clear() {
+    bookings.clear();
+    conflicts.clear();
+}
+
+// ================================================================
+//                  AVAILABILITY
+// ================================================================
+bool BookingIntervals::isFree(int checkIn, int checkOut) const {
+    // Last booking that starts before the requested check-out
+    auto it = bookings.lower_bound(checkOut);
+    if (it != bookings.begin() && checkIn < prev(it)->second.checkOut)
+        return false;
+
+    for (auto& b : conflicts)
+        if (checkIn < b.checkOut && b.checkIn < checkOut) return false;
+
+    return true;
+}
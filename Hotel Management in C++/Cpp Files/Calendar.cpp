@@ -0,0 +1,85 @@
+#include "Calendar.h"
+
+#include <ctime>
+#include <cstdio>
+
+using namespace std;
+
+// ================================================================
+//                  COMPILE-TIME CHECKS
+// ================================================================
+namespace {
+
+// Every day of the range survives day -> civil -> day and text -> day
+constexpr bool roundTrips(int from, int to) {
+    for (int day = from; day < to; day++) {
+        Calendar::Civil c = Calendar::civilFromDays(day);
+        if (!Calendar::isValid(c.year, c.month, c.day)) return false;
+        if (Calendar::daysFromCivil(c.year, c.month, c.day) != day) return false;
+        if (Calendar::weekday(day + 1) != (Calendar::weekday(day) + 1) % 7) return false;
+    }
+    return true;
+}
+
+static_assert(Calendar::daysFromCivil(1970, 1, 1) == 0, "epoch");
+static_assert(Calendar::daysFromCivil(2000, 3, 1) == 11017, "days_from_civil");
+static_assert(Calendar::daysFromCivil(1969, 12, 31) == -1, "before the epoch");
+static_assert(Calendar::civilFromDays(19782).year == 2024 && Calendar::civilFromDays(19782).month == 2 &&
+    Calendar::civilFromDays(19782).day == 29, "civil_from_days");
+
+static_assert(Calendar::parseDay("2024-02-29") == 19782, "leap day");
+static_assert(Calendar::parseDay("2023-02-29") == Calendar::NoDay, "not a leap year");
+static_assert(Calendar::parseDay("1900-02-29") == Calendar::NoDay, "century");
+static_assert(Calendar::parseDay("2000-02-29") != Calendar::NoDay, "400-year leap");
+static_assert(Calendar::parseDay("2024-04-31") == Calendar::NoDay, "30-day month");
+static_assert(Calendar::parseDay("2024-13-01") == Calendar::NoDay, "month range");
+static_assert(Calendar::parseDay("2024-1-01") == Calendar::NoDay, "width");
+static_assert(Calendar::parseDay("2024/01/01") == Calendar::NoDay, "separators");
+static_assert(Calendar::parseDay("20a4-01-01") == Calendar::NoDay, "digits");
+
+static_assert(Calendar::weekday(0) == 4, "1970-01-01 was a Thursday");
+static_assert(Calendar::weekday(-1) == 3, "1969-12-31 was a Wednesday");
+static_assert(Calendar::weekday(Calendar::parseDay("2026-10-17")) == 6, "Saturday");
+
+// One full leap cycle (kept short for compilers with low constexpr step limits)
+static_assert(roundTrips(Calendar::daysFromCivil(2024, 1, 1), Calendar::daysFromCivil(2028, 1, 1)), "round trip");
+
+} // namespace
+
+// ================================================================
+//                  DAY NUMBER -> TEXT
+// ================================================================
+string Calendar::fromDay(int day) {
+    if (day == NoDay) return "";
+
+    Civil c = civilFromDays(day);
+    if (c.year < 0 || c.year > 9999) {
+        char wide[32];
+        snprintf(wide, sizeof wide, "%04d-%02u-%02u", c.year, c.month, c.day);
+        return wide;
+    }
+
+    char buf[10] = {
+        static_cast<char>('0' + c.year / 1000), static_cast<char>('0' + c.year / 100 % 10),
+        static_cast<char>('0' + c.year / 10 % 10), static_cast<char>('0' + c.year % 10), '-',
+        static_cast<char>('0' + c.month / 10), static_cast<char>('0' + c.month % 10), '-',
+        static_cast<char>('0' + c.day / 10), static_cast<char>('0' + c.day % 10)
+    };
+    return string(buf, sizeof buf);
+}
+
+// ================================================================
+//                  TODAY
+// ================================================================
+int Calendar::today() {
+    time_t now = time(nullptr);
+    tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+
+    return daysFromCivil(local.tm_year + 1900, static_cast<unsigned>(local.tm_mon + 1),
+        static_cast<unsigned>(local.tm_mday));
+}
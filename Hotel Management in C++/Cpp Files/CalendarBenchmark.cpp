@@ -0,0 +1,212 @@
+#include "CalendarBenchmark.h"
+#include "Calendar.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+// ================================================================
+//                  BASELINE (previous date helpers)
+// ================================================================
+namespace {
+
+struct Date {
+    int y, m, d;
+};
+
+bool parseDate(const string& s, Date& dt) {
+    if (s.size() != 10 || s[4] != '-' || s[7] != '-') return false;
+    try {
+        dt.y = stoi(s.substr(0, 4));
+        dt.m = stoi(s.substr(5, 2));
+        dt.d = stoi(s.substr(8, 2));
+    }
+    catch (...) {
+        return false;
+    }
+    return true;
+}
+
+bool isValidCalendarDate(const Date& dt) {
+    if (dt.y < 1900 || dt.m < 1 || dt.m > 12 || dt.d < 1) return false;
+
+    int mdays[] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+
+    bool leap = (dt.y % 4 == 0 && dt.y % 100 != 0) || (dt.y % 400 == 0);
+    if (leap) mdays[1] = 29;
+
+    return dt.d <= mdays[dt.m - 1];
+}
+
+time_t toTimeT(const Date& dt) {
+    tm t = {};
+    t.tm_year = dt.y - 1900;
+    t.tm_mon = dt.m - 1;
+    t.tm_mday = dt.d;
+    return mktime(&t);
+}
+
+tm localNow() {
+    time_t now = time(nullptr);
+    tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return local;
+}
+
+bool isBeforeToday(const Date& dt) {
+    tm today = localNow();
+    today.tm_hour = today.tm_min = today.tm_sec = 0;
+    return toTimeT(dt) < mktime(&today);
+}
+
+int calculateNights(const string& in, const string& out) {
+    int y1 = stoi(in.substr(0, 4)), m1 = stoi(in.substr(5, 2)), d1 = stoi(in.substr(8, 2));
+    int y2 = stoi(out.substr(0, 4)), m2 = stoi(out.substr(5, 2)), d2 = stoi(out.substr(8, 2));
+
+    tm a = {};
+    a.tm_year = y1 - 1900; a.tm_mon = m1 - 1; a.tm_mday = d1;
+
+    tm b = {};
+    b.tm_year = y2 - 1900; b.tm_mon = m2 - 1; b.tm_mday = d2;
+
+    return static_cast<int>((mktime(&b) - mktime(&a)) / (60 * 60 * 24));
+}
+
+string formatDate(const Date& dt) {
+    char buf[32];
+    snprintf(buf, sizeof buf, "%04d-%02d-%02d", dt.y, dt.m, dt.d);
+    return buf;
+}
+
+// ================================================================
+//                  TIMING
+// ================================================================
+// Best of rounds; the result of the last round is returned in check so
+// both sides can be compared and are not optimized away
+double bestOf(int rounds, const function<long long()>& work, long long& check) {
+    double best = 0;
+    for (int round = 0; round < max(rounds, 1); round++) {
+        auto start = chrono::steady_clock::now();
+        check = work();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        best = round == 0 ? ms : min(best, ms);
+    }
+    return best;
+}
+
+} // namespace
+
+// ================================================================
+//                  RUN
+// ================================================================
+void CalendarBenchmark::run(size_t dateCount, int rounds) {
+    // Check-in dates spread over 2020-2039, stays of 1-14 nights
+    vector<string> checkIns, checkOuts;
+    vector<Date> parsed;
+    checkIns.reserve(dateCount);
+    checkOuts.reserve(dateCount);
+    parsed.reserve(dateCount);
+
+    int first = Calendar::daysFromCivil(2020, 1, 1);
+    for (size_t i = 0; i < dateCount; i++) {
+        int in = first + static_cast<int>((i * 7919) % 7305);
+        int out = in + 1 + static_cast<int>(i % 14);
+        checkIns.push_back(Calendar::fromDay(in));
+        checkOuts.push_back(Calendar::fromDay(out));
+
+        Calendar::Civil c = Calendar::civilFromDays(in);
+        parsed.push_back({ c.year, static_cast<int>(c.month), static_cast<int>(c.day) });
+    }
+
+    stringstream out;
+    out << "\n===== CALENDAR BENCHMARK =====\n"
+        << dateCount << " dates (best of " << rounds << ")\n\n"
+        << left << setw(18) << "Operation"
+        << right << setw(12) << "libc (ms)" << setw(14) << "Calendar (ms)" << setw(10) << "Speedup" << "\n";
+    cout << out.str();
+
+    struct Case {
+        const char* name;
+        function<long long()> baseline;
+        function<long long()> calendar;
+    };
+
+    vector<Case> cases = {
+        { "parse + validate",
+            [&] {
+                long long valid = 0;
+                for (auto& s : checkIns) {
+                    Date d;
+                    valid += parseDate(s, d) && isValidCalendarDate(d);
+                }
+                return valid;
+            },
+            [&] {
+                long long valid = 0;
+                for (auto& s : checkIns) valid += Calendar::parseDay(s) != Calendar::NoDay;
+                return valid;
+            } },
+        { "nights",
+            [&] {
+                long long nights = 0;
+                for (size_t i = 0; i < dateCount; i++) nights += calculateNights(checkIns[i], checkOuts[i]);
+                return nights;
+            },
+            [&] {
+                long long nights = 0;
+                for (size_t i = 0; i < dateCount; i++)
+                    nights += Calendar::parseDay(checkOuts[i]) - Calendar::parseDay(checkIns[i]);
+                return nights;
+            } },
+        { "before today",
+            [&] {
+                long long before = 0;
+                for (auto& d : parsed) before += isBeforeToday(d);
+                return before;
+            },
+            [&] {
+                long long before = 0;
+                for (auto& s : checkIns) before += Calendar::parseDay(s) < Calendar::today();
+                return before;
+            } },
+        { "format",
+            [&] {
+                long long length = 0;
+                for (auto& d : parsed) length += static_cast<long long>(formatDate(d).size());
+                return length;
+            },
+            [&] {
+                long long length = 0;
+                for (auto& s : checkIns) length += static_cast<long long>(Calendar::fromDay(Calendar::parseDay(s)).size());
+                return length;
+            } },
+    };
+
+    for (auto& c : cases) {
+        long long expected = 0, actual = 0;
+        double libc = bestOf(rounds, c.baseline, expected);
+        double calendar = bestOf(rounds, c.calendar, actual);
+
+        stringstream row;
+        row << fixed << setprecision(1)
+            << left << setw(18) << c.name
+            << right << setw(12) << libc << setw(14) << calendar
+            << setw(9) << (calendar > 0 ? libc / calendar : 0.0) << "x";
+        if (expected != actual) row << "  (results differ)";
+        row << "\n";
+        cout << row.str();
+    }
+}
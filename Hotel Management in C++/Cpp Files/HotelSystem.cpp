@@ -1,75 +1,90 @@
 #include "HotelSystem.h"
 #include "Scheduler.h"
+#include "SaxLoader.h"
+#include "BinaryStore.h"
+#include "AtomicFile.h"
+#include "JsonWriter.h"
+#include "ReservationShards.h"
+#include "Calendar.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <regex>
-#include <ctime>
 #include <iomanip>
+#include <map>
+#include <future>
+#include <chrono>
+#include <climits>
+#include <unordered_set>
 
 
-struct Date {
-    int y, m, d;
-};
+using namespace std;
+using json = nlohmann::json;
 
-// Parse YYYY-MM-DD
-bool parseDate(const string& s, Date& dt) {
-    if (s.size() != 10 || s[4] != '-' || s[7] != '-') return false;
-    try {
-        dt.y = stoi(s.substr(0, 4));
-        dt.m = stoi(s.substr(5, 2));
-        dt.d = stoi(s.substr(8, 2));
-    }
-    catch (...) {
-        return false;
-    }
-    return true;
+// Compact journal records, keys sorted like json::dump. One writer buffer
+// is reused for every record.
+static JsonWriter recordWriter;
+
+string putCustomerRecord(const Customer& c) {
+    recordWriter.clear();
+    recordWriter.beginObject();
+    recordWriter.key("customer");
+    c.write_json(recordWriter);
+    recordWriter.field("op", "putCustomer");
+    recordWriter.endObject();
+    return recordWriter.str();
 }
 
-// Check real calendar validity (including leap years)
-bool isValidCalendarDate(const Date& dt) {
-    if (dt.y < 1900 || dt.m < 1 || dt.m > 12 || dt.d < 1) return false;
-
-    int mdays[] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
-
-    bool leap = (dt.y % 4 == 0 && dt.y % 100 != 0) || (dt.y % 400 == 0);
-    if (leap) mdays[1] = 29;
-
-    return dt.d <= mdays[dt.m - 1];
+string putReservationRecord(const Reservation& r, const Customer* c = nullptr) {
+    recordWriter.clear();
+    recordWriter.beginObject();
+    if (c) {
+        recordWriter.key("customer");
+        c->write_json(recordWriter);
+    }
+    recordWriter.field("op", "putReservation");
+    recordWriter.key("reservation");
+    r.write_json(recordWriter);
+    recordWriter.endObject();
+    return recordWriter.str();
 }
 
-// Convert to time_t
-time_t toTimeT(const Date& dt) {
-    tm t = {};
-    t.tm_year = dt.y - 1900;
-    t.tm_mon = dt.m - 1;
-    t.tm_mday = dt.d;
-    return mktime(&t);
+string putRoomRecord(const Room& room) {
+    recordWriter.clear();
+    recordWriter.beginObject();
+    recordWriter.field("op", "putRoom");
+    recordWriter.key("room");
+    room.write_json(recordWriter);
+    recordWriter.endObject();
+    return recordWriter.str();
 }
 
-// Check if the date is before today's date
-bool isBeforeToday(const Date& dt) {
-    time_t now = time(nullptr);
-    tm local{};
-    localtime_s(&local, &now);
-
-    tm today = local;
-    today.tm_hour = today.tm_min = today.tm_sec = 0;
-
-    return toTimeT(dt) < mktime(&today);
+string deleteRecord(const char* op, int id) {
+    recordWriter.clear();
+    recordWriter.beginObject();
+    recordWriter.field("id", id);
+    recordWriter.field("op", op);
+    recordWriter.endObject();
+    return recordWriter.str();
 }
 
-
-
-using namespace std;
-using json = nlohmann::json;
-
 // ================================================================
 //                  CONSTRUCTOR & INITIALIZATION
 // ================================================================
-HotelSystem::HotelSystem() {
+HotelSystem::HotelSystem(const string& storageName, int archiveHorizonDays, bool journalMode)
+    : storage(StorageBackend::create(storageName)), archiveHorizonDays(archiveHorizonDays),
+      journalMode(journalMode) {
+    if (!storage) {
+        cout << "Warning: unknown storage backend '" << storageName << "', using binary.\n";
+        storage = StorageBackend::create("binary");
+    }
+
+    customersSnapshot = "customers" + storage->extension();
+    reservationsSnapshot = "reservations" + storage->extension();
+    roomsSnapshot = "rooms" + storage->extension();
+
     initializeRooms();   // Build hotel structure
     loadData();          // Load customers, reservations, rooms
 }
@@ -94,128 +109,690 @@ void HotelSystem::initializeRooms() {
     for (int i = 301; i <= 306; i++) {
         rooms.emplace_back(i, 3, "Suite", 450.0);
     }
+
+    roomIndex.build(rooms);
+    rebuildRoomBookings();
 }
 
 // ================================================================
 //                  AUTO SAVE (AFTER EVERY CHANGE)
 // ================================================================
-void HotelSystem::autoSave() const {
-    saveData();
+// In journal mode the mutation is appended to the log as one compact
+// record; the snapshot files are only rewritten every checkpointInterval
+// records (and on exit). Both are queued to the persistence thread, so
+// the operator never waits for the disk. With journal mode off every
+// mutation is a checkpoint of the collections it changed; only when that
+// checkpoint is refused does the record go to the journal.
+void HotelSystem::autoSave(const string& record) {
+    if (!journalMode && checkpoint())
+        return;
+
+    persistence.appendRecord(record);
+
+    if (++journalRecords >= checkpointInterval)
+        checkpoint();
+}
+
+// ================================================================
+//                  CHECKPOINT
+// ================================================================
+// Hands immutable copies of the dirty collections to the persistence
+// thread, which encodes and writes them and then truncates the journal.
+// Returns false when the checkpoint is refused.
+bool HotelSystem::checkpoint() {
+    vector<PersistenceWorker::SnapshotFile> files;
+
+    if (reservationsDirty || !dirtyReservationMonths.empty()) ensureReservationsLoaded();
+    dirtyReservationMonths.insert(restoredMonths.begin(), restoredMonths.end());
+    restoredMonths.clear();
+
+    // Writing the month of an unreadable shard would replace its stays
+    // with the few changes made since; the journal keeps them instead
+    for (auto& entry : unreadableShards) {
+        if (reservationsDirty || dirtyReservationMonths.count(entry.first)) {
+            cout << "Warning: " << ReservationShards::shardPath(reservationsDir, entry.first)
+                << " is corrupted and cannot be rewritten; checkpoint skipped, the changes stay in the journal.\n";
+            return false;
+        }
+    }
+
+    if (archiveReset || !archivePending.empty()) {
+        files.push_back({ archiveFile,
+            [copy = std::move(archivePending)]() { return ReservationArchive::encodeBlock(copy); },
+            !archiveReset,
+            [archive = archive](const string& block) { return archive.append(block); } });
+        archivePending.clear();
+        archiveReset = false;
+    }
+
+    if (customersDirty) {
+        files.push_back({ customersSnapshot,
+            [copy = customers, storage = storage]() { return storage->encodeCustomers(copy); } });
+    }
+
+    if (reservationsDirty || !dirtyReservationMonths.empty()) {
+        ensureReservationsLoaded();
+        if (binarySnapshots()) {
+            queueReservationShards(files);
+        }
+        else {
+            files.push_back({ reservationsSnapshot,
+                [copy = reservations.values(), storage = storage]() { return storage->encodeReservations(copy); } });
+        }
+    }
+
+    if (roomsDirty) {
+        files.push_back({ roomsSnapshot,
+            [copy = rooms, storage = storage]() { return storage->encodeRooms(copy); } });
+    }
+
+    persistence.checkpoint(std::move(files));
+
+    customersDirty = reservationsDirty = roomsDirty = false;
+    dirtyReservationMonths.clear();
+    journalRecords = 0;
+    return true;
+}
+
+// ================================================================
+//                  RESERVATION SHARDS
+// ================================================================
+void HotelSystem::markReservationDirty(const Reservation& r) {
+    dirtyReservationMonths.insert(ReservationShards::monthOf(r.getCheckInDay()));
+}
+
+// Groups the reservations by check-in month. Only the dirty months are
+// copied and queued (a month that became empty is rewritten empty); the
+// manifest is rebuilt from every month and written last.
+void HotelSystem::queueReservationShards(vector<PersistenceWorker::SnapshotFile>& files) {
+    map<string, vector<Reservation>> changed;
+    for (auto& month : dirtyReservationMonths) changed[month];
+    if (reservationsDirty)
+        for (auto& s : reservationShards) changed[s.month];
+
+    // Unreadable shards keep their file and manifest entry
+    map<string, ReservationShard> months(unreadableShards.begin(), unreadableShards.end());
+    for (auto& r : reservations) {
+        string month = ReservationShards::monthOf(r.getCheckInDay());
+
+        ReservationShard& s = months[month];
+        s.month = month;
+        s.count++;
+        s.maxId = max(s.maxId, r.getId());
+
+        if (reservationsDirty || dirtyReservationMonths.count(month))
+            changed[month].push_back(r);
+    }
+
+    for (auto& [month, list] : changed) {
+        files.push_back({ ReservationShards::shardPath(reservationsDir, month),
+            [copy = std::move(list)]() { return BinaryStore::encodeReservations(copy); } });
+    }
+
+    reservationShards.clear();
+    for (auto& [month, s] : months) reservationShards.push_back(s);
+
+    files.push_back({ ReservationShards::manifestPath(reservationsDir),
+        [manifest = reservationShards]() { return ReservationShards::encodeManifest(manifest); } });
 }
 
 // ================================================================
 //                  MAIN SAVE FUNCTION
 // ================================================================
-void HotelSystem::saveData() const {
-    saveCustomersJSON();
-    saveReservationsJSON();
-    saveRoomsJSON();
+// Checkpoint and wait until it is on disk (used on exit)
+void HotelSystem::saveData() {
+    checkpoint();
+    persistence.flush();
 }
 // ================================================================
 //                  MAIN LOAD FUNCTION
 // ================================================================
+// Each file is loaded on its own thread. The threads only share the room
+// list: the reservation loader reads the room numbers and types (fixed by
+// initializeRooms) to build the booking index, while the rooms loader only
+// adds comments and reservation IDs to the rooms. Each loader sets only
+// its own dirty flag. The journal replay, the ID fix-up and archiving
+// (which changes rooms and reservations and checkpoints) run after the join.
 void HotelSystem::loadData() {
-    loadCustomersJSON();
-    loadReservationsJSON();
-    loadRoomsJSON();
+    auto timed = [](HotelSystem* self, void (HotelSystem::*load)()) {
+        auto start = chrono::steady_clock::now();
+        (self->*load)();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    auto customersTime = async(launch::async, timed, this, &HotelSystem::loadCustomers);
+    auto reservationsTime = async(launch::async, timed, this, &HotelSystem::loadReservations);
+    auto roomsTime = async(launch::async, timed, this, &HotelSystem::loadRooms);
+
+    stringstream timings;
+    timings << fixed << setprecision(1)
+        << "Loaded customers in " << customersTime.get() << " ms, "
+        << "reservations in " << reservationsTime.get() << " ms, "
+        << "rooms in " << roomsTime.get() << " ms.\n";
+    cout << timings.str();
+
+    // Re-apply mutations logged after the last checkpoint
+    replayJournal();
+
+    updateNextIds();
+    archiveCompletedReservations();
+}
 
-    // Fix next IDs based on loaded data
+// A collection without a valid snapshot in the selected backend is
+// loaded from its .json file and migrated at the next checkpoint
+void HotelSystem::loadCustomers() {
+    if (jsonSnapshots() || !loadCustomersSnapshot()) {
+        if (loadCustomersJSON() && !jsonSnapshots()) customersDirty = true;
+    }
+
+    indexCustomers();
+}
+
+void HotelSystem::loadReservations() {
+    if (!jsonSnapshots() && loadReservationsSnapshot()) return;
+
+    if (loadReservationsJSON() && !jsonSnapshots()) reservationsDirty = true;
+}
+
+void HotelSystem::loadRooms() {
+    if (!jsonSnapshots() && loadRoomsSnapshot()) return;
+
+    if (loadRoomsJSON() && !jsonSnapshots()) roomsDirty = true;
+}
+
+// Fix next IDs based on loaded data
+void HotelSystem::updateNextIds() {
     for (auto& c : customers)
         nextCustomerId = max(nextCustomerId, c.getId() + 1);
 
+    if (!reservationsMaterialized) {
+        for (auto& s : reservationShards)
+            nextReservationId = max(nextReservationId, s.maxId + 1);
+    }
+
+    // Stays of a corrupted shard are not loaded, but their IDs stay taken
+    for (auto& entry : unreadableShards)
+        nextReservationId = max(nextReservationId, entry.second.maxId + 1);
+
     for (auto& r : reservations)
         nextReservationId = max(nextReservationId, r.getId() + 1);
+
+    // Archived IDs are never reused (block headers only)
+    nextReservationId = max(nextReservationId, archive.maxId() + 1);
+}
+
+// ================================================================
+//                  COLD ARCHIVE
+// ================================================================
+int HotelSystem::archiveCutoff() const {
+    return Calendar::today() - archiveHorizonDays;
+}
+
+// Moves the stays that checked out before the cutoff out of the working
+// set. The archive block is appended by the checkpoint that rewrites
+// their shards, before the shards are replaced.
+void HotelSystem::archiveCompletedReservations() {
+    if (archiveHorizonDays < 0) return;
+
+    int cutoff = archiveCutoff();
+
+    // Check the old months in place before decoding every shard
+    if (!reservationsMaterialized) {
+        string cutoffMonth = ReservationShards::monthOf(cutoff);
+        bool found = false;
+        forEachShardRecord([&](const string& month) { return month <= cutoffMonth; },
+            [&](const ReservationView& r) { found = found || r.getCheckOutDay() < cutoff; });
+        if (!found) return;
+    }
+
+    ensureReservationsLoaded();
+
+    vector<Reservation> cold;
+    for (auto& r : reservations)
+        if (r.getCheckOutDay() < cutoff && ReservationArchive::isArchivable(r))
+            cold.push_back(r);
+    if (cold.empty()) return;
+
+    for (auto& r : cold) {
+        Room* room = getRoomRef(r.getRoomNumber());
+        if (room) room->removeReservation(r.getId());
+        markReservationDirty(r);
+        eraseReservation(r.getId());
+    }
+
+    roomsDirty = true;
+    archivePending.insert(archivePending.end(), cold.begin(), cold.end());
+
+    cout << "Archived " << cold.size() << " completed reservation(s).\n";
+    checkpoint();
+}
+
+// ================================================================
+//                  LAZY RESERVATION STORE
+// ================================================================
+// Decodes every month shard into the reservations vector the first
+// time anything other than the read-only listings needs it.
+void HotelSystem::ensureReservationsLoaded() const {
+    if (reservationsMaterialized) return;
+
+    vector<Reservation> loaded;
+    vector<Reservation> json;
+    bool jsonRead = false;
+    for (auto& s : reservationShards) {
+        string path = ReservationShards::shardPath(reservationsDir, s.month);
+
+        // Each shard is unmapped as soon as it is decoded
+        MappedReservations shard;
+        size_t before = loaded.size();
+        if (shard.open(path) && shard.materialize(loaded)) continue;
+        loaded.resize(before);
+
+        // Fall back to the month in the JSON file, if it still holds as
+        // many stays as the manifest lists
+        if (!jsonRead) {
+            ifstream f(reservationsFile);
+            jsonRead = true;
+            if (!f.good() || !isCompleteJSONArray(reservationsFile) || !loadReservationsSax(f, json))
+                json.clear();
+        }
+
+        vector<Reservation> month;
+        for (auto& r : json)
+            if (ReservationShards::monthOf(r.getCheckInDay()) == s.month) month.push_back(r);
+
+        if (month.size() >= s.count) {
+            cout << "Warning: " << path << " is corrupted; its month is restored from "
+                << reservationsFile << ", reservations made after it was written are missing.\n";
+            loaded.insert(loaded.end(), month.begin(), month.end());
+            restoredMonths.insert(s.month);
+        }
+        else {
+            cout << "Error: " << path << " is corrupted and " << reservationsFile
+                << " has no full copy of its month. Its reservations are not loaded, and the file"
+                << " is kept as it is: changes to that month stay in the journal.\n";
+            unreadableShards[s.month] = s;
+        }
+    }
+
+    setReservations(std::move(loaded));
+    reservationsMaterialized = true;
+}
+
+// Visits the records of the shards whose month passes keepMonth, mapping
+// one shard at a time (read-only listings before materialization)
+template <class Keep, class Visit>
+void HotelSystem::forEachShardRecord(Keep keepMonth, Visit visit) const {
+    for (auto& s : reservationShards) {
+        if (!keepMonth(s.month)) continue;
+
+        string path = ReservationShards::shardPath(reservationsDir, s.month);
+        MappedReservations shard;
+        if (!shard.open(path)) {
+            cout << "Warning: " << path << " is corrupted, skipped.\n";
+            continue;
+        }
+
+        for (size_t i = 0; i < shard.size(); i++) visit(shard[i]);
+    }
 }
 
 // ================================================================
 //                  JSON LOAD FUNCTIONS
 // ================================================================
-void HotelSystem::loadCustomersJSON() {
+bool HotelSystem::loadCustomersJSON() {
     customers.clear();
 
     ifstream f(customersFile);
-    if (!f.good()) return;
+    if (!f.good()) {
+        customersDirty = true;   // create the file at the next checkpoint
+        return true;
+    }
 
-    json j;
-    f >> j;
+    if (!isCompleteJSONArray(customersFile)) {
+        cout << "Warning: " << customersFile << " is incomplete (torn write), ignored.\n";
+        return false;
+    }
 
-    for (auto& obj : j) {
-        customers.push_back(Customer::from_json(obj));
+    // Streamed straight into Customer objects (no json DOM)
+    if (!loadCustomersSax(f, customers)) {
+        cout << "Warning: " << customersFile << " is not a valid customer list, ignored.\n";
+        return false;
     }
+    return true;
 }
 
-void HotelSystem::loadReservationsJSON() {
-    reservations.clear();
+bool HotelSystem::loadReservationsJSON() {
+    reservationsMaterialized = true;
+    setReservations({});
 
     ifstream f(reservationsFile);
-    if (!f.good()) return;
+    if (!f.good()) {
+        reservationsDirty = true;
+        return true;
+    }
 
-    json j;
-    f >> j;
+    if (!isCompleteJSONArray(reservationsFile)) {
+        cout << "Warning: " << reservationsFile << " is incomplete (torn write), ignored.\n";
+        return false;
+    }
 
-    for (auto& obj : j) {
-        reservations.push_back(Reservation::from_json(obj));
+    vector<Reservation> loaded;
+    if (!loadReservationsSax(f, loaded)) {
+        cout << "Warning: " << reservationsFile << " is not a valid reservation list, ignored.\n";
+        return false;
+    }
+    fitRoomTypes(loaded);
+    setReservations(std::move(loaded));
+    return true;
+}
+
+// A longer type could not be saved in the binary snapshots (every
+// checkpoint would fail), so it is never accepted as it is
+size_t HotelSystem::fitRoomTypes(vector<Reservation>& list) const {
+    size_t removed = 0;
+    for (size_t i = 0; i < list.size();) {
+        Reservation& r = list[i];
+        if (r.getRoomType().size() <= BinaryStore::RoomTypeWidth) {
+            i++;
+            continue;
+        }
+
+        const Room* room = getRoomConst(r.getRoomNumber());
+        if (room) {
+            cout << "Warning: reservation " << r.getId() << " has room type \"" << r.getRoomType()
+                << "\" (longer than " << BinaryStore::RoomTypeWidth << " characters); using the type of room "
+                << room->getRoomNumber() << ", " << room->getType() << ".\n";
+            r.setRoomType(room->getType());
+            i++;
+        }
+        else {
+            cout << "Error: reservation " << r.getId() << " has room type \"" << r.getRoomType()
+                << "\" (longer than " << BinaryStore::RoomTypeWidth << " characters) and no room of the hotel; not loaded.\n";
+            list.erase(list.begin() + i);
+            removed++;
+        }
     }
+    return removed;
 }
 
-void HotelSystem::loadRoomsJSON() {
+bool HotelSystem::loadRoomsJSON() {
     ifstream f(roomsFile);
-    if (!f.good()) return;  // If file missing, use initialized rooms
+    if (!f.good()) {        // If file missing, use initialized rooms
+        roomsDirty = true;
+        return true;
+    }
 
-    json j; f >> j;
+    if (!isCompleteJSONArray(roomsFile)) {
+        cout << "Warning: " << roomsFile << " is incomplete (torn write), ignored.\n";
+        return false;
+    }
 
-    // Overwrite initialized rooms (same room numbers)
-    unordered_map<int, Room> temp;
+    vector<Room> loadedRooms;
+    if (!loadRoomsSax(f, loadedRooms)) {
+        cout << "Warning: " << roomsFile << " is not a valid room list, ignored.\n";
+        return false;
+    }
 
-    for (auto& obj : j) {
-        Room r = Room::from_json(obj);
-        temp[r.getRoomNumber()] = r;
+    mergeLoadedRooms(loadedRooms);
+    return true;
+}
+
+void HotelSystem::mergeLoadedRooms(const vector<Room>& loadedRooms) {
+    // Update initialized rooms (same room numbers) with comments + history;
+    // rooms that are no longer part of the hotel are dropped
+    for (auto& loaded : loadedRooms) {
+        Room* r = getRoomRef(loaded.getRoomNumber());
+        if (!r) continue;
+
+        // Update comments
+        for (auto& c : loaded.getComments())
+            r->addComment(c);
+
+        // Update reservation IDs
+        for (auto& rid : loaded.getReservationIds())
+            r->addReservation(rid);
     }
+}
 
-    // Update existing rooms with comments + history
-    for (auto& r : rooms) {
-        if (temp.count(r.getRoomNumber())) {
-            Room loaded = temp[r.getRoomNumber()];
+// ================================================================
+//                  SNAPSHOT LOAD (STORAGE BACKEND)
+// ================================================================
+bool HotelSystem::loadCustomersSnapshot() {
+    if (!ifstream(customersSnapshot).good()) return false;
+
+    if (!storage->isComplete(customersSnapshot, BinaryStore::Customers)) {
+        cout << "Warning: " << customersSnapshot << " is incomplete (torn write), falling back to JSON.\n";
+        return false;
+    }
+
+    string bytes;
+    if (!BinaryStore::readFile(customersSnapshot, bytes)) return false;
+
+    customers.clear();
+    if (storage->decodeCustomers(bytes, customers)) return true;
+
+    cout << "Warning: " << customersSnapshot << " is corrupted, falling back to JSON.\n";
+    customers.clear();
+    return false;
+}
+
+bool HotelSystem::loadReservationsSnapshot() {
+    if (binarySnapshots()) return loadReservationsBinary();
+
+    setReservations({});
+    reservationShards.clear();
+    reservationsMaterialized = true;
+
+    if (!ifstream(reservationsSnapshot).good()) return false;
+
+    if (!storage->isComplete(reservationsSnapshot, BinaryStore::Reservations)) {
+        cout << "Warning: " << reservationsSnapshot << " is incomplete (torn write), falling back to JSON.\n";
+        return false;
+    }
+
+    string bytes;
+    if (!BinaryStore::readFile(reservationsSnapshot, bytes)) return false;
+
+    vector<Reservation> loaded;
+    if (storage->decodeReservations(bytes, loaded)) {
+        setReservations(std::move(loaded));
+        return true;
+    }
+
+    cout << "Warning: " << reservationsSnapshot << " is corrupted, falling back to JSON.\n";
+    return false;
+}
+
+// Reservations are not decoded here: only the shard manifest is read, and
+// the month shards are mapped on demand until something needs
+// Reservation objects
+bool HotelSystem::loadReservationsBinary() {
+    setReservations({});
+    reservationShards.clear();
+
+    string manifest = ReservationShards::manifestPath(reservationsDir);
+    if (ifstream(manifest).good()) {
+        string error;
+        if (ReservationShards::readManifest(reservationsDir, reservationShards, error)) {
+            reservationsMaterialized = false;
+            return true;
+        }
+
+        // The JSON export may be far older than the shards: rebuild the
+        // manifest from the shard files instead
+        cout << "Error: " << manifest << " is corrupted (" << error
+            << "). Rebuilding it from the shard files.\n";
+
+        vector<Reservation> loaded;
+        for (auto& month : ReservationShards::listShards(reservationsDir)) {
+            string path = ReservationShards::shardPath(reservationsDir, month);
+            MappedReservations shard;
+            vector<Reservation> records;
+            if (!shard.open(path) || !shard.materialize(records)) {
+                cout << "Error: " << path << " is corrupted as well; falling back to "
+                    << reservationsFile << ", reservations made after it was written are missing.\n";
+                return false;
+            }
+            loaded.insert(loaded.end(), records.begin(), records.end());
+        }
+
+        setReservations(std::move(loaded));
+        reservationsMaterialized = true;
+        reservationsDirty = true;
+        return true;
+    }
+
+    // Single pre-shard snapshot: decoded once, split into months at the
+    // next checkpoint
+    if (!ifstream(reservationsBinFile).good()) return false;
+
+    MappedReservations legacy;
+    vector<Reservation> loaded;
+    if (!legacy.open(reservationsBinFile) || !legacy.materialize(loaded)) {
+        cout << "Warning: " << reservationsBinFile << " is corrupted, falling back to JSON.\n";
+        return false;
+    }
+
+    setReservations(std::move(loaded));
+
+    reservationsMaterialized = true;
+    reservationsDirty = true;
+    return true;
+}
+
+bool HotelSystem::loadRoomsSnapshot() {
+    if (!ifstream(roomsSnapshot).good()) return false;
+
+    if (!storage->isComplete(roomsSnapshot, BinaryStore::Rooms)) {
+        cout << "Warning: " << roomsSnapshot << " is incomplete (torn write), falling back to JSON.\n";
+        return false;
+    }
+
+    string bytes;
+    if (!BinaryStore::readFile(roomsSnapshot, bytes)) return false;
+
+    vector<Room> loadedRooms;
+    if (!storage->decodeRooms(bytes, loadedRooms)) {
+        cout << "Warning: " << roomsSnapshot << " is corrupted, falling back to JSON.\n";
+        return false;
+    }
+
+    mergeLoadedRooms(loadedRooms);
+    return true;
+}
+
+// ================================================================
+//                  JOURNAL REPLAY
+// ================================================================
+void HotelSystem::replayJournal() {
+    vector<json> records = journal.readAll();
+    for (auto& record : records)
+        applyJournalRecord(record);
+
+    journalRecords = records.size();
+}
+
+// Every record is an upsert or a delete, so replaying a record that is
+// already contained in the snapshot leaves the state unchanged.
+void HotelSystem::applyJournalRecord(const json& record) {
+    string op = record.value("op", "");
+
+    if (op == "putCustomer") {
+        upsertCustomer(Customer::from_json(record.at("customer")));
+    }
+    else if (op == "deleteCustomer") {
+        eraseCustomer(record.at("id").get<int>());
+    }
+    else if (op == "putReservation") {
+        upsertReservation(Reservation::from_json(record.at("reservation")));
+        if (record.contains("customer"))
+            upsertCustomer(Customer::from_json(record.at("customer")));
+    }
+    else if (op == "deleteReservation") {
+        removeReservation(record.at("id").get<int>());
+    }
+    else if (op == "putRoom") {
+        Room loaded = Room::from_json(record.at("room"));
+        Room* room = getRoomRef(loaded.getRoomNumber());
+        if (room) {
+            *room = loaded;
+            roomsDirty = true;
+        }
+    }
+}
 
-            // Update comments
-            for (auto& c : loaded.getComments())
-                r.addComment(c);
+void HotelSystem::upsertCustomer(const Customer& c) {
+    Customer* existing = getCustomerRef(c.getId());
+    if (existing) *existing = c;
+    else insertCustomer(c);
 
-            // Update reservation IDs
-            for (auto& rid : loaded.getReservationIds())
-                r.addReservation(rid);
+    customersDirty = true;
+}
+
+void HotelSystem::upsertReservation(const Reservation& r) {
+    Reservation* existing = reservations.get(findReservation(r.getId()));
+    if (existing) {
+        if (existing->getRoomNumber() != r.getRoomNumber()) {
+            Room* oldRoom = getRoomRef(existing->getRoomNumber());
+            if (oldRoom) oldRoom->removeReservation(r.getId());
+            roomsDirty = true;
         }
+        markReservationDirty(*existing);
+        unlinkCustomer(*existing);
+        unlinkBooking(*existing);
+        *existing = r;
+        linkCustomer(r);
+        linkBooking(r);
+    }
+    else {
+        insertReservation(r);
     }
+
+    Room* room = getRoomRef(r.getRoomNumber());
+    if (room && find(room->getReservationIds().begin(), room->getReservationIds().end(),
+        r.getId()) == room->getReservationIds().end()) {
+        room->addReservation(r.getId());
+        roomsDirty = true;
+    }
+
+    markReservationDirty(r);
+}
+
+// Remove a reservation and unlink it from its room
+void HotelSystem::removeReservation(int id) {
+    const Reservation* r = reservations.get(findReservation(id));
+    if (!r) return;
+
+    Room* room = getRoomRef(r->getRoomNumber());
+    if (room) room->removeReservation(id);
+    markReservationDirty(*r);
+    markScheduleWindow(r->getRoomType(), r->getCheckInDay(), r->getCheckOutDay());
+
+    eraseReservation(id);
+    roomsDirty = true;
 }
 
 // ================================================================
 //                  JSON SAVE FUNCTIONS
 // ================================================================
+// Written to a temp file and renamed, so a crash never leaves a
+// half-written export behind
 void HotelSystem::saveCustomersJSON() const {
-    json j = json::array();
-    for (auto& c : customers)
-        j.push_back(c.to_json());
-
-    ofstream f(customersFile);
-    f << j.dump(4);
+    AtomicFile::write(customersFile, jsonFormat->encodeCustomers(customers));
 }
 
+// The export holds the full history: archived stays, then the working set
 void HotelSystem::saveReservationsJSON() const {
-    json j = json::array();
-    for (auto& r : reservations)
-        j.push_back(r.to_json());
+    vector<Reservation> all;
+    archive.forEach([&](const Reservation& r) { all.push_back(r); });
 
-    ofstream f(reservationsFile);
-    f << j.dump(4);
+    ensureReservationsLoaded();
+    all.insert(all.end(), reservations.begin(), reservations.end());
+    AtomicFile::write(reservationsFile, jsonFormat->encodeReservations(all));
 }
 
 void HotelSystem::saveRoomsJSON() const {
-    json j = json::array();
-    for (auto& r : rooms)
-        j.push_back(r.to_json());
-
-    ofstream f(roomsFile);
-    f << j.dump(4);
+    AtomicFile::write(roomsFile, jsonFormat->encodeRooms(rooms));
 }
 
 // ================================================================
@@ -229,68 +806,157 @@ double HotelSystem::getBasePriceForRoomType(const string& type) const {
 }
 
 bool HotelSystem::validDate(const string& d) const {
-    return d.size() == 10 &&
-        d[4] == '-' && d[7] == '-' &&
-        isdigit(d[0]) && isdigit(d[1]) &&
-        isdigit(d[2]) && isdigit(d[3]) &&
-        isdigit(d[5]) && isdigit(d[6]) &&
-        isdigit(d[8]) && isdigit(d[9]);
+    return Calendar::parseDay(d) != Calendar::NoDay;
 }
 
-// Count how many nights (simple YYYY-MM-DD string compare)
-int HotelSystem::calculateNights(const string& in, const string& out) const {
-    int y1 = stoi(in.substr(0, 4)), m1 = stoi(in.substr(5, 2)), d1 = stoi(in.substr(8, 2));
-    int y2 = stoi(out.substr(0, 4)), m2 = stoi(out.substr(5, 2)), d2 = stoi(out.substr(8, 2));
+// Count how many nights (day numbers)
+int HotelSystem::calculateNights(int in, int out) const {
+    return out - in;
+}
 
-    tm a = {};
-    a.tm_year = y1 - 1900; a.tm_mon = m1 - 1; a.tm_mday = d1;
+// ================================================================
+//               FINDERS FOR CUSTOMERS / ROOMS / RESERVATIONS
+// ================================================================
+// Customers are found through customerIndex (ID -> slot); every change
+// to the vector goes through the three helpers below to keep it in sync.
+void HotelSystem::indexCustomers() {
+    customerIndex.clear();
+    customerIndex.reserve(customers.size());
+
+    // emplace keeps the first slot if a file holds an ID twice
+    for (size_t i = 0; i < customers.size(); i++)
+        customerIndex.emplace(customers[i].getId(), i);
+}
+
+void HotelSystem::insertCustomer(const Customer& c) {
+    customers.push_back(c);
+    customerIndex.emplace(c.getId(), customers.size() - 1);
+    customersDirty = true;
+}
+
+// Keeps the list order (customers are listed in insertion order); the
+// slots after the erased one shift down by one
+void HotelSystem::eraseCustomer(int id) {
+    auto it = customerIndex.find(id);
+    if (it == customerIndex.end()) return;
 
-    tm b = {};
-    b.tm_year = y2 - 1900; b.tm_mon = m2 - 1; b.tm_mday = d2;
+    size_t slot = it->second;
+    customerIndex.erase(it);
+    customers.erase(customers.begin() + slot);
 
-    time_t t1 = mktime(&a);
-    time_t t2 = mktime(&b);
+    for (size_t i = slot; i < customers.size(); i++)
+        customerIndex[customers[i].getId()] = i;
 
-    return (t2 - t1) / (60 * 60 * 24);
+    customersDirty = true;
 }
 
-// ================================================================
-//               FINDERS FOR CUSTOMERS / ROOMS / RESERVATIONS
-// ================================================================
 Customer* HotelSystem::getCustomerRef(int id) {
-    for (auto& c : customers)
-        if (c.getId() == id) return &c;
-    return nullptr;
+    auto it = customerIndex.find(id);
+    return it == customerIndex.end() ? nullptr : &customers[it->second];
 }
 
 optional<Customer> HotelSystem::getCustomerOptional(int id) const {
-    for (auto& c : customers)
-        if (c.getId() == id) return c;
-    return nullopt;
+    auto it = customerIndex.find(id);
+    if (it == customerIndex.end()) return nullopt;
+    return customers[it->second];
 }
 
-Reservation* HotelSystem::getReservationRef(int id) {
-    for (auto& r : reservations)
-        if (r.getId() == id) return &r;
-    return nullptr;
+// Reservations are found through reservationIndex (ID -> slot map
+// handle); every change to the slot map goes through these helpers.
+void HotelSystem::setReservations(vector<Reservation> list) const {
+    reservations.assign(std::move(list));
+
+    reservationIndex.clear();
+    reservationIndex.reserve(reservations.size());
+    customerReservations.clear();
+    for (size_t i = 0; i < reservations.size(); i++) {
+        const Reservation& r = reservations.values()[i];
+        reservationIndex.emplace(r.getId(), reservations.handleAt(i));
+        linkCustomer(r);
+    }
+
+    rebuildRoomBookings();
 }
 
-const Reservation* HotelSystem::getReservationConst(int id) const {
-    for (auto& r : reservations)
-        if (r.getId() == id) return &r;
-    return nullptr;
+void HotelSystem::insertReservation(const Reservation& r) {
+    reservationIndex[r.getId()] = reservations.insert(r);
+    linkCustomer(r);
+    linkBooking(r);
+}
+
+void HotelSystem::eraseReservation(int id) {
+    auto it = reservationIndex.find(id);
+    if (it == reservationIndex.end()) return;
+
+    const Reservation& r = *reservations.get(it->second);
+    unlinkCustomer(r);
+    unlinkBooking(r);
+    reservations.erase(it->second);
+    reservationIndex.erase(it);
+}
+
+void HotelSystem::linkCustomer(const Reservation& r) const {
+    customerReservations[r.getCustomerId()].push_back(r.getId());
+}
+
+void HotelSystem::unlinkCustomer(const Reservation& r) const {
+    auto it = customerReservations.find(r.getCustomerId());
+    if (it == customerReservations.end()) return;
+
+    vector<int>& ids = it->second;
+    ids.erase(remove(ids.begin(), ids.end(), r.getId()), ids.end());
+    if (ids.empty()) customerReservations.erase(it);
+}
+
+void HotelSystem::linkBooking(const Reservation& r) const {
+    int slot = roomIndex.find(r.getRoomNumber());
+    if (slot < 0) return;
+
+    roomBookings[slot].add(r.getCheckInDay(), r.getCheckOutDay(), r.getId());
+    availability.book(slot, r.getCheckInDay(), r.getCheckOutDay());
+}
+
+void HotelSystem::unlinkBooking(const Reservation& r) const {
+    int slot = roomIndex.find(r.getRoomNumber());
+    if (slot < 0) return;
+
+    roomBookings[slot].remove(r.getCheckInDay(), r.getId());
+    availability.release(slot, r.getCheckInDay(), r.getCheckOutDay());
+
+    // An overlapping booking may still hold some of these nights
+    if (roomBookings[slot].hasConflicts()) {
+        for (int d = r.getCheckInDay(); d < r.getCheckOutDay(); d++)
+            if (!roomBookings[slot].isFree(d, d + 1))
+                availability.book(slot, d, d + 1);
+    }
+}
+
+void HotelSystem::rebuildRoomBookings() const {
+    roomBookings.assign(rooms.size(), BookingIntervals());
+    availability.reset(rooms, Calendar::today());
+    for (auto& r : reservations) linkBooking(r);
+}
+
+// The bitmaps start at today: move the horizon when the date has changed
+void HotelSystem::refreshAvailability() const {
+    if (availability.getFirstDay() != Calendar::today())
+        rebuildRoomBookings();
+}
+
+SlotMap<Reservation>::Handle HotelSystem::findReservation(int id) const {
+    ensureReservationsLoaded();
+    auto it = reservationIndex.find(id);
+    return it == reservationIndex.end() ? SlotMap<Reservation>::Handle() : it->second;
 }
 
 Room* HotelSystem::getRoomRef(int roomNumber) {
-    for (auto& r : rooms)
-        if (r.getRoomNumber() == roomNumber) return &r;
-    return nullptr;
+    int slot = roomIndex.find(roomNumber);
+    return slot < 0 ? nullptr : &rooms[slot];
 }
 
 const Room* HotelSystem::getRoomConst(int roomNumber) const {
-    for (auto& r : rooms)
-        if (r.getRoomNumber() == roomNumber) return &r;
-    return nullptr;
+    int slot = roomIndex.find(roomNumber);
+    return slot < 0 ? nullptr : &rooms[slot];
 }
 
 // ================================================================
@@ -329,10 +995,10 @@ void HotelSystem::addCustomer() {
             cout << "Invalid email. Must contain @ and end with .com, gmail.com, hotmail.com, or .lau.edu\n";
     } while (!regex_match(email, emailPattern));
 
-    customers.emplace_back(nextCustomerId++, name, phone, email);
+    insertCustomer(Customer(nextCustomerId++, name, phone, email));
     cout << "Customer added successfully.\n";
 
-    autoSave();
+    autoSave(putCustomerRecord(customers.back()));
 }
 
 
@@ -363,30 +1029,30 @@ void HotelSystem::editCustomer() {
     if (!name.empty()) c->setName(name);
     if (!phone.empty()) c->setPhone(phone);
     if (!email.empty()) c->setEmail(email);
+    customersDirty = true;
 
     cout << "Customer updated.\n";
-    autoSave();
+    autoSave(putCustomerRecord(*c));
 }
 
 void HotelSystem::deleteCustomer() {
     cout << "Enter Customer ID to Delete: ";
     int id; cin >> id;
 
-    // Cannot delete customer with existing reservations
-    for (auto& r : reservations)
-        if (r.getCustomerId() == id) {
-            cout << "Cannot delete this customer. They have reservations.\n";
-            return;
-        }
+    // Cannot delete customer with existing reservations (archived ones
+    // are only read when the working set has none)
+    ensureReservationsLoaded();
+    bool hasReservations = customerReservations.count(id) > 0;
 
-    customers.erase(
-        remove_if(customers.begin(), customers.end(),
-            [&](const Customer& c) { return c.getId() == id; }),
-        customers.end()
-    );
+    if (hasReservations || archive.hasCustomer(id)) {
+        cout << "Cannot delete this customer. They have reservations.\n";
+        return;
+    }
+
+    eraseCustomer(id);
 
     cout << "Customer deleted.\n";
-    autoSave();
+    autoSave(deleteRecord("deleteCustomer", id));
 }
 
 void HotelSystem::listCustomers() const {
@@ -427,16 +1093,31 @@ void HotelSystem::findCustomerByIdMenu() const {
     cout << "Past Bookings: " << c.getTotalBookings() << "\n";
 
     cout << "\n===== Customer Reservations =====\n";
+    ensureReservationsLoaded();
 
-    for (auto& r : reservations) {
-        if (r.getCustomerId() == id) {
-            cout << "Reservation #" << r.getId()
-                << " | Room " << r.getRoomNumber()
-                << " | " << r.getCheckIn() << " -> " << r.getCheckOut()
-                << " | Nights: " << r.getNights()
-                << " | Final Price: $" << r.getFinalPrice()
-                << "\n";
-        }
+    auto print = [](const Reservation& r) {
+        cout << "Reservation #" << r.getId()
+            << " | Room " << r.getRoomNumber()
+            << " | " << r.getCheckIn() << " -> " << r.getCheckOut()
+            << " | Nights: " << r.getNights()
+            << " | Final Price: $" << r.getFinalPrice()
+            << "\n";
+    };
+
+    // Completed stays come from the archive; only blocks whose customer
+    // range contains this ID are decoded
+    vector<int> current;
+    auto own = customerReservations.find(id);
+    if (own != customerReservations.end()) current = own->second;
+
+    unordered_set<int> inWorkingSet(current.begin(), current.end());
+    archive.forCustomer(id, [&](const Reservation& r) {
+        if (!inWorkingSet.count(r.getId())) print(r);
+    });
+
+    for (int rid : current) {
+        const Reservation* r = reservations.get(findReservation(rid));
+        if (r) print(*r);
     }
 }
 // ================================================================
@@ -456,18 +1137,15 @@ void HotelSystem::listAllRooms() const {
 }
 
 void HotelSystem::listAvailableRooms() const {
-    cout << "\n===== Available Rooms =====\n";
-
-    for (auto& room : rooms) {
-        bool isReserved = false;
-        for (auto& res : reservations) {
-            if (res.getRoomNumber() == room.getRoomNumber()) {
-                isReserved = true;
-                break;
-            }
-        }
+    cout << "\n===== Available Rooms (tonight) =====\n";
+    ensureReservationsLoaded();
+    refreshAvailability();
 
-        if (!isReserved) {
+    int today = availability.getFirstDay();
+    for (size_t i = 0; i < rooms.size(); i++) {
+        const Room& room = rooms[i];
+
+        if (!availability.isBooked(static_cast<int>(i), today)) {
             cout << "Room " << room.getRoomNumber()
                 << " | Floor " << room.getFloor()
                 << " | Type: " << room.getType()
@@ -507,17 +1185,16 @@ void HotelSystem::addReservation() {
     // ============================
 
     string checkInStr, checkOutStr;
-    Date checkIn, checkOut;
+    int inDay, outDay;
+    int today = Calendar::today();
 
     // Ask CHECK-IN date until valid
     while (true) {
         cout << "Check-in date (YYYY-MM-DD): ";
         cin >> checkInStr;
 
-        if (!parseDate(checkInStr, checkIn) ||
-            !isValidCalendarDate(checkIn) ||
-            isBeforeToday(checkIn))
-        {
+        inDay = Calendar::parseDay(checkInStr);
+        if (inDay == Calendar::NoDay || inDay < today) {
             cout << "Invalid check-in date. Please try again.\n";
             continue;
         }
@@ -529,15 +1206,13 @@ void HotelSystem::addReservation() {
         cout << "Check-out date (YYYY-MM-DD): ";
         cin >> checkOutStr;
 
-        if (!parseDate(checkOutStr, checkOut) ||
-            !isValidCalendarDate(checkOut) ||
-            isBeforeToday(checkOut))
-        {
+        outDay = Calendar::parseDay(checkOutStr);
+        if (outDay == Calendar::NoDay || outDay < today) {
             cout << "Invalid check-out date. Please try again.\n";
             continue;
         }
 
-        if (toTimeT(checkIn) >= toTimeT(checkOut)) {
+        if (inDay >= outDay) {
             cout << "Check-out date must be after check-in date. Try again.\n";
             continue;
         }
@@ -552,30 +1227,53 @@ void HotelSystem::addReservation() {
     int assignedRoom = -1;
     int assignedFloor = 0;
 
-    for (auto& room : rooms) {
-        if (room.getType() == type) {
-            bool occupied = false;
-
-            for (auto& res : reservations) {
-                if (res.getRoomNumber() == room.getRoomNumber()) {
-                    // checking overlap
-                    if (!(checkOutStr <= res.getCheckIn() ||
-                        res.getCheckOut() <= checkInStr))
-                    {
-                        occupied = true;
-                        break;
-                    }
-                }
-            }
+    ensureReservationsLoaded();
+    refreshAvailability();
+
+    // Best fit among the rooms of the type free for the stay: fewest
+    // stranded nights (gaps too short to sell) created, then the room
+    // whose previous stay ends closest to the check-in, then room order.
+    // Inside their horizon the day bitmaps tell at once if none is free.
+    int slot = -1;
+    bool anyFree = !availability.covers(inDay, outDay) ||
+        availability.findFree(type, inDay, outDay) >= 0;
+    int bestStranded = 0, bestLead = 0;
+    for (size_t i = 0; anyFree && i < rooms.size(); i++) {
+        if (rooms[i].getType() != type || !roomBookings[i].isFree(inDay, outDay))
+            continue;
 
-            if (!occupied) {
-                assignedRoom = room.getRoomNumber();
-                assignedFloor = room.getFloor();
-                break;
+        int prevOut, nextIn;
+        roomBookings[i].neighbors(inDay, outDay, prevOut, nextIn);
+        int stranded = Scheduler::strandedNights(prevOut, inDay) + Scheduler::strandedNights(outDay, nextIn)
+            - Scheduler::strandedNights(prevOut, nextIn);
+        int lead = prevOut == INT_MIN ? INT_MAX : inDay - prevOut;
+
+        if (slot < 0 || stranded < bestStranded || (stranded == bestStranded && lead < bestLead)) {
+            slot = static_cast<int>(i);
+            bestStranded = stranded;
+            bestLead = lead;
+        }
+    }
+
+    // Every room is taken for some of the nights: moving the stays that
+    // overlap the new one (and only those) may still make room for it
+    if (slot < 0) {
+        ReplanResult plan = planComponent(type, inDay, outDay, true);
+        if (plan.planned) {
+            slot = plan.newStaySlot;
+            if (!plan.moves.empty()) {
+                cout << "Moving " << plan.moves.size() << " reservation(s) to other rooms to fit this stay:";
+                printRoomMoves(plan.moves);
+                applyRoomMoves(plan.moves);
             }
         }
     }
 
+    if (slot >= 0) {
+        assignedRoom = rooms[slot].getRoomNumber();
+        assignedFloor = rooms[slot].getFloor();
+    }
+
     if (assignedRoom == -1) {
         cout << "No available rooms of this type.\n";
         return;
@@ -585,7 +1283,7 @@ void HotelSystem::addReservation() {
     // PRICE AND RESERVATION SAVE
     // ============================
 
-    int nights = calculateNights(checkInStr, checkOutStr);
+    int nights = calculateNights(inDay, outDay);
     double basePrice = getBasePriceForRoomType(type);
     double finalPrice = nights * basePrice;
 
@@ -595,8 +1293,8 @@ void HotelSystem::addReservation() {
     Reservation r(
         nextReservationId++,
         cid,
-        checkInStr,
-        checkOutStr,
+        inDay,
+        outDay,
         assignedRoom,
         assignedFloor,
         type,
@@ -604,18 +1302,21 @@ void HotelSystem::addReservation() {
         finalPrice
     );
 
-    reservations.push_back(r);
+    insertReservation(r);
 
     Room* roomRef = getRoomRef(assignedRoom);
     if (roomRef)
         roomRef->addReservation(r.getId());
 
     cu->incrementBookings();
+    customersDirty = roomsDirty = true;
+    markReservationDirty(r);
+    markScheduleWindow(type, inDay, outDay);
 
     printInvoice(r, cu->getTotalBookings() >= 3);
 
     cout << "Reservation added.\n";
-    autoSave();
+    autoSave(putReservationRecord(r, cu));
 }
 
 
@@ -623,30 +1324,16 @@ void HotelSystem::cancelReservation() {
     cout << "Enter Reservation ID to cancel: ";
     int rid; cin >> rid;
 
-    Reservation* r = getReservationRef(rid);
-    if (!r) {
+    if (!reservations.get(findReservation(rid))) {
         cout << "Reservation not found.\n";
         return;
     }
 
-    int roomNum = r->getRoomNumber();
-
-    // Remove from room history
-    Room* room = getRoomRef(roomNum);
-    if (room) {
-        auto& vec = const_cast<vector<int>&>(room->getReservationIds());
-        vec.erase(remove(vec.begin(), vec.end(), rid), vec.end());
-    }
-
-    // Remove reservation entirely
-    reservations.erase(
-        remove_if(reservations.begin(), reservations.end(),
-            [&](const Reservation& rr) { return rr.getId() == rid; }),
-        reservations.end()
-    );
+    // Remove from room history and drop the reservation entirely
+    removeReservation(rid);
 
     cout << "Reservation cancelled.\n";
-    autoSave();
+    autoSave(deleteRecord("deleteReservation", rid));
 }
 
 
@@ -705,6 +1392,11 @@ void HotelSystem::adminMenu() {
         cout << "5) List All Reservations\n";
         cout << "6) List Past Reservations\n";
         cout << "7) List Future Reservations\n";
+        cout << "8) Export Data to JSON\n";
+        cout << "9) Import Data from JSON\n";
+        cout << "10) Re-plan All Rooms (full scheduler)\n";
+        cout << "11) Preview Room Moves (dry run)\n";
+        cout << "12) Compact Room Plan (fewer short gaps)\n";
         cout << "0) Exit Admin Menu\n";
         cout << "Choice: ";
         cin >> choice;
@@ -717,6 +1409,11 @@ void HotelSystem::adminMenu() {
         case 5: listReservations(); break;
         case 6: listPastReservations(); break;
         case 7: listFutureReservations(); break;
+        case 8: exportJSON(); break;
+        case 9: importJSON(); break;
+        case 10: runFullScheduler(); break;
+        case 11: adminPreviewSchedule(); break;
+        case 12: adminCompactSchedule(); break;
         case 0: break;
         default: cout << "Invalid choice.\n";
         }
@@ -729,28 +1426,16 @@ void HotelSystem::adminCancelReservation() {
     cout << "\nEnter Reservation ID to cancel: ";
     int rid; cin >> rid;
 
-    Reservation* r = getReservationRef(rid);
-    if (!r) {
+    if (!reservations.get(findReservation(rid))) {
         cout << "Reservation not found.\n";
         return;
     }
 
-    int roomNum = r->getRoomNumber();
-
-    // Remove from room history
-    Room* room = getRoomRef(roomNum);
-    if (room) {
-        auto& vec = const_cast<vector<int>&>(room->getReservationIds());
-        vec.erase(remove(vec.begin(), vec.end(), rid), vec.end());
-    }
-    reservations.erase(
-        remove_if(reservations.begin(), reservations.end(),
-            [&](const Reservation& rr) { return rr.getId() == rid; }),
-        reservations.end()
-    );
+    // Remove from room history and drop the reservation entirely
+    removeReservation(rid);
 
     cout << "Reservation cancelled.\n";
-    autoSave();
+    autoSave(deleteRecord("deleteReservation", rid));
 }
 
 // ================================================================
@@ -760,20 +1445,22 @@ void HotelSystem::adminModifyReservationPrice() {
     cout << "\nEnter Reservation ID: ";
     int rid; cin >> rid;
 
-    Reservation* r = getReservationRef(rid);
-    if (!r) {
+    SlotMap<Reservation>::Handle h = findReservation(rid);
+    if (!reservations.get(h)) {
         cout << "Reservation not found.\n";
         return;
     }
 
-    cout << "Current price: $" << r->getFinalPrice() << "\n";
+    cout << "Current price: $" << reservations.get(h)->getFinalPrice() << "\n";
     cout << "Enter new price: ";
     double p; cin >> p;
 
-    r->setFinalPrice(p);
+    Reservation& r = *reservations.get(h);
+    r.setFinalPrice(p);
+    markReservationDirty(r);
 
     cout << "Reservation price updated.\n";
-    autoSave();
+    autoSave(putReservationRecord(r));
 }
 
 // ================================================================
@@ -795,9 +1482,10 @@ void HotelSystem::adminAddRoomComment() {
     getline(cin, c);
 
     room->addComment(c);
+    roomsDirty = true;
 
     cout << "Comment added.\n";
-    autoSave();
+    autoSave(putRoomRecord(*room));
 }
 
 // ================================================================
@@ -822,27 +1510,93 @@ void HotelSystem::adminViewAllComments() {
     }
 }
 
+// ================================================================
+//                 ADMIN: JSON EXPORT / IMPORT
+// ================================================================
+void HotelSystem::exportJSON() {
+    saveCustomersJSON();
+    saveReservationsJSON();
+    saveRoomsJSON();
+
+    cout << "Data exported to " << customersFile << ", "
+        << reservationsFile << " and " << roomsFile << ".\n";
+}
+
+// Replaces the current data with the contents of the JSON files
+void HotelSystem::importJSON() {
+    if (!ifstream(customersFile).good() || !ifstream(reservationsFile).good() ||
+        !ifstream(roomsFile).good()) {
+        cout << "JSON files not found. Nothing imported.\n";
+        return;
+    }
+
+    // Check all three files before replacing anything
+    {
+        vector<Customer> c;
+        vector<Reservation> r;
+        vector<Room> rm;
+        ifstream fc(customersFile), fr(reservationsFile), frm(roomsFile);
+        if (!isCompleteJSONArray(customersFile) || !loadCustomersSax(fc, c) ||
+            !isCompleteJSONArray(reservationsFile) || !loadReservationsSax(fr, r) ||
+            !isCompleteJSONArray(roomsFile) || !loadRoomsSax(frm, rm)) {
+            cout << "Warning: the JSON files are damaged or incomplete. Nothing imported.\n";
+            return;
+        }
+        if (fitRoomTypes(r) > 0) {
+            cout << "Warning: some reservations cannot be stored. Nothing imported.\n";
+            return;
+        }
+    }
+
+    initializeRooms();
+    loadCustomersJSON();
+    indexCustomers();
+    loadReservationsJSON();
+    loadRoomsJSON();
+
+    // The imported stays replace every shard, corrupted ones included
+    restoredMonths.clear();
+    unreadableShards.clear();
+
+    // The export holds the archived stays too: the archive is rebuilt from
+    // the completed stays of the file, replacing the old one
+    archivePending.clear();
+    archiveReset = true;
+    customersDirty = reservationsDirty = roomsDirty = true;
+    archiveCompletedReservations();
+    checkpoint();
+
+    // Next IDs from the imported data only (the archive is read from disk)
+    persistence.flush();
+    nextCustomerId = nextReservationId = 1;
+    updateNextIds();
+
+    scheduleWindows.clear();
+    scheduleWindowsKnown = false;
+
+    cout << "Data imported from JSON.\n";
+}
+
 // ================================================================
 //                 LIST RESERVATIONS (SORTED)
 // ================================================================
 void HotelSystem::sortReservations() {
-    sort(reservations.begin(), reservations.end(),
+    ensureReservationsLoaded();
+    reservations.sort(
         [&](const Reservation& a, const Reservation& b) {
             if (a.getCustomerId() != b.getCustomerId())
                 return a.getCustomerId() < b.getCustomerId();
-            return a.getCheckIn() < b.getCheckIn();
+            return a.getCheckInDay() < b.getCheckInDay();
         });
 }
 
+// The listings read Reservation objects or, before the store has been
+// materialized, the ReservationView records of the mapped month shards
+// (same getters). Past/future listings only map the months they need.
 void HotelSystem::listReservations() const {
     cout << "\n===== ALL RESERVATIONS =====\n";
 
-    if (reservations.empty()) {
-        cout << "No reservations found.\n";
-        return;
-    }
-
-    for (auto& r : reservations) {
+    auto print = [](const auto& r) {
         cout << "Res#" << r.getId()
             << " | Cust#" << r.getCustomerId()
             << " | Room " << r.getRoomNumber()
@@ -850,60 +1604,372 @@ void HotelSystem::listReservations() const {
             << " | Nights: " << r.getNights()
             << " | Price: $" << r.getFinalPrice()
             << "\n";
+    };
+
+    // Archived (completed) stays first
+    size_t count = 0;
+    archive.forEach([&](const Reservation& r) { print(r); count++; });
+
+    count += reservations.size();
+    if (!reservationsMaterialized)
+        for (auto& s : reservationShards) count += s.count;
+    if (count == 0) {
+        cout << "No reservations found.\n";
+        return;
+    }
+
+    if (reservationsMaterialized) {
+        for (auto& r : reservations) print(r);
+    }
+    else {
+        forEachShardRecord([](const string&) { return true; }, print);
     }
 }
 
 void HotelSystem::listPastReservations() const {
     cout << "\n===== PAST RESERVATIONS =====\n";
 
-    string today = getToday(); 
+    int today = getToday();
 
-    for (auto& r : reservations) {
-        if (r.getCheckOut() < today) {
+    auto print = [&](const auto& r) {
+        if (r.getCheckOutDay() < today) {
             cout << "Res#" << r.getId()
                 << " | Cust#" << r.getCustomerId()
                 << " | Room " << r.getRoomNumber()
                 << " | " << r.getCheckIn() << " -> " << r.getCheckOut()
                 << "\n";
         }
+    };
+
+    // Most past stays live in the archive
+    archive.forEach([&](const Reservation& r) { print(r); });
+
+    if (reservationsMaterialized) {
+        for (auto& r : reservations) print(r);
+    }
+    else {
+        // Nothing that checked in after this month can have checked out
+        string thisMonth = ReservationShards::monthOf(today);
+        forEachShardRecord([&](const string& month) {
+            return month <= thisMonth || month == ReservationShards::Undated;
+        }, print);
     }
 }
 
 void HotelSystem::listFutureReservations() const {
     cout << "\n===== FUTURE RESERVATIONS =====\n";
 
-    string today = getToday();
+    int today = getToday();
 
-    for (auto& r : reservations) {
-        if (r.getCheckIn() > today) {
+    auto print = [&](const auto& r) {
+        if (r.getCheckInDay() > today) {
             cout << "Res#" << r.getId()
                 << " | Cust#" << r.getCustomerId()
                 << " | Room " << r.getRoomNumber()
                 << " | " << r.getCheckIn() << " -> " << r.getCheckOut()
                 << "\n";
         }
+    };
+
+    if (reservationsMaterialized) {
+        for (auto& r : reservations) print(r);
+    }
+    else {
+        // Months before this one only hold stays that already started
+        string thisMonth = ReservationShards::monthOf(today);
+        forEachShardRecord([&](const string& month) { return month >= thisMonth; }, print);
     }
 }
 
 
-string HotelSystem::getToday() const {
-    time_t t = time(nullptr);
-    struct tm now;
-    localtime_s(&now, &t);
-
-    stringstream ss;
-    ss << put_time(&now, "%Y-%m-%d");
-    cout << "Today is " << ss.str()<<endl;
-    return ss.str();
+int HotelSystem::getToday() const {
+    int today = Calendar::today();
+    cout << "Today is " << Calendar::fromDay(today) << endl;
+    return today;
 }
 
 // ================================================================
 //                        RUN SCHEDULER
 // ================================================================
 void HotelSystem::runScheduler() {
-    Scheduler::allocateRooms(reservations, rooms);
-    cout << "Scheduling completed.\n";
-    autoSave();
+    if (!scheduleWindowsKnown) {
+        cout << "Changes made before this session are not tracked. Re-planning all rooms.\n";
+        runFullScheduler();
+        return;
+    }
+
+    if (scheduleWindows.empty()) {
+        cout << "No bookings or cancellations since the last run. Nothing to re-plan.\n";
+        return;
+    }
+
+    SchedulePlan plan = planScheduleWindows();
+    applyRoomMoves(plan.moves);
+    scheduleWindows.clear();
+
+    cout << "Re-planned " << plan.components << " window(s): " << plan.stays
+        << " reservation(s), " << plan.moves.size() << " moved.\n";
+    if (plan.overbooked > 0)
+        cout << "Warning: " << plan.overbooked << " window(s) have more overlapping stays than rooms and were left as they are.\n";
+}
+
+void HotelSystem::runFullScheduler() {
+    ensureReservationsLoaded();
+
+    // Stays that already started keep their room; only the reservations
+    // whose room changes are touched
+    vector<Scheduler::RoomMove> moves =
+        Scheduler::planMoves(reservations.values(), rooms, Calendar::today());
+    applyRoomMoves(moves);
+    scheduleWindows.clear();
+    scheduleWindowsKnown = true;
+    cout << "Scheduling completed. " << moves.size() << " reservation(s) moved.\n";
+}
+
+// Dry run of either scheduler: lists the room changes without making them
+void HotelSystem::adminPreviewSchedule() const {
+    cout << "\n1) Changes since the last run\n";
+    cout << "2) Full re-plan\n";
+    cout << "Choice: ";
+    int choice; cin >> choice;
+
+    if (choice == 1 && !scheduleWindowsKnown) {
+        cout << "Changes made before this session are not tracked; showing the full re-plan.\n";
+        choice = 2;
+    }
+
+    vector<Scheduler::RoomMove> moves;
+    if (choice == 1) {
+        SchedulePlan plan = planScheduleWindows();
+        moves = std::move(plan.moves);
+        if (plan.overbooked > 0)
+            cout << "Warning: " << plan.overbooked << " window(s) have more overlapping stays than rooms.\n";
+    }
+    else if (choice == 2) {
+        ensureReservationsLoaded();
+        moves = Scheduler::planMoves(reservations.values(), rooms, Calendar::today());
+    }
+    else {
+        cout << "Invalid choice.\n";
+        return;
+    }
+
+    printRoomMoves(moves);
+}
+
+// Optimizing mode: plans the stays that have not started for as few
+// stranded nights as possible, within compactBudgetMs, shows the gain
+// over first-fit and the moves, and applies them on confirmation
+void HotelSystem::adminCompactSchedule() {
+    ensureReservationsLoaded();
+
+    Scheduler::CompactReport report;
+    vector<int> planned = Scheduler::planCompact(reservations.values(), rooms, Calendar::today(),
+        chrono::milliseconds(compactBudgetMs), report);
+    vector<Scheduler::RoomMove> moves = Scheduler::movesTo(reservations.values(), planned);
+
+    cout << "\nStranded room-nights (gaps under " << Scheduler::SellableGap << " nights):\n";
+    cout << "  First-fit:    " << report.firstFit << "\n";
+    cout << "  Current plan: " << report.current << "\n";
+    cout << "  Compact plan: " << report.compact << "\n";
+    cout << "Recovered vs first-fit: " << report.firstFit - report.compact << " room-night(s)";
+    if (report.budgetUsedUp) cout << " (time budget of " << compactBudgetMs << " ms used up)";
+    cout << "\n";
+
+    printRoomMoves(moves);
+    if (moves.empty()) return;
+
+    cout << "Apply these moves? (y/n): ";
+    string answer; cin >> answer;
+    if (answer != "y" && answer != "Y") {
+        cout << "Room plan left unchanged.\n";
+        return;
+    }
+
+    applyRoomMoves(moves);
+    scheduleWindows.clear();
+    cout << "Room plan compacted.\n";
+}
+
+void HotelSystem::printRoomMoves(const vector<Scheduler::RoomMove>& moves) const {
+    if (moves.empty()) {
+        cout << "No reservation would change room.\n";
+        return;
+    }
+
+    cout << "\n===== ROOM MOVES (" << moves.size() << ") =====\n";
+    for (auto& m : moves) {
+        const Reservation* r = reservations.get(findReservation(m.reservationId));
+        cout << "Reservation " << m.reservationId;
+        if (r) cout << " (" << r->getCheckIn() << " to " << r->getCheckOut() << ")";
+        cout << ": room ";
+        if (m.fromRoom >= 0) cout << m.fromRoom; else cout << "none";
+        cout << " -> ";
+        if (m.toRoom >= 0) cout << m.toRoom; else cout << "none (overbooked)";
+        cout << "\n";
+    }
+}
+
+void HotelSystem::markScheduleWindow(const string& type, int from, int to) {
+    if (from < to) scheduleWindows[type].push_back({ from, to });
+}
+
+// Plans every pending window without changing anything
+HotelSystem::SchedulePlan HotelSystem::planScheduleWindows() const {
+    SchedulePlan result;
+    ensureReservationsLoaded();
+    refreshAvailability();
+
+    for (auto& entry : scheduleWindows) {
+        vector<pair<int, int>> windows = entry.second;
+        sort(windows.begin(), windows.end());
+
+        // A window inside the span of the previous component belongs to
+        // it; the part sticking out can only reach other stays
+        int coveredTo = Calendar::NoDay;
+        for (auto& w : windows) {
+            int from = max(w.first, coveredTo);
+            if (from >= w.second) continue;
+
+            ReplanResult plan = planComponent(entry.first, from, w.second, false);
+            if (plan.stays == 0) continue;
+
+            result.components++;
+            result.stays += plan.stays;
+            if (!plan.planned) result.overbooked++;
+            result.moves.insert(result.moves.end(), plan.moves.begin(), plan.moves.end());
+            coveredTo = max(coveredTo, plan.to);
+        }
+    }
+    return result;
+}
+
+// Plans the stays of one room type connected to [from, to) by overlap
+// (directly or through other stays). Stays outside the component do not
+// overlap its span, so they cannot be affected; stays that already
+// started are pinned and only keep their room busy until they check out.
+// Nothing is changed: the result lists the moves.
+// Cost: the rooms of the type plus the stays of the component.
+HotelSystem::ReplanResult HotelSystem::planComponent(const string& type, int from, int to,
+    bool withNewStay) const {
+
+    ReplanResult result;
+    ensureReservationsLoaded();
+    int today = Calendar::today();
+
+    vector<int> slots;                       // component room -> slot in rooms
+    vector<int> roomOfSlot(rooms.size(), -1);
+    for (size_t i = 0; i < rooms.size(); i++) {
+        if (rooms[i].getType() != type) continue;
+        roomOfSlot[i] = static_cast<int>(slots.size());
+        slots.push_back(static_cast<int>(i));
+    }
+    if (slots.empty()) return result;
+
+    // Grow the span until no movable stay crosses its ends; only the
+    // newly added edges need to be scanned again
+    vector<int> ids;
+    vector<int> preferred;
+    unordered_set<int> seen;
+    int lo = from, hi = to;
+    vector<pair<int, int>> frontier{ { from, to } };
+    while (!frontier.empty()) {
+        pair<int, int> edge = frontier.back();
+        frontier.pop_back();
+
+        for (int s : slots) {
+            roomBookings[s].forEachOverlap(edge.first, edge.second, [&](int in, int out, int id) {
+                if (in < today || !seen.insert(id).second) return;
+
+                ids.push_back(id);
+                preferred.push_back(roomOfSlot[s]);
+                if (in < lo) { frontier.push_back({ in, lo }); lo = in; }
+                if (out > hi) { frontier.push_back({ hi, out }); hi = out; }
+            });
+        }
+    }
+
+    result.from = lo;
+    result.to = hi;
+    result.stays = ids.size();
+
+    // Pinned stays overlapping the span hold their room until check-out
+    vector<int> releaseDays(slots.size(), Scheduler::Unused);
+    for (size_t k = 0; k < slots.size(); k++) {
+        roomBookings[slots[k]].forEachOverlap(lo, hi, [&](int in, int out, int) {
+            if (in < today) releaseDays[k] = max(releaseDays[k], out);
+        });
+    }
+
+    vector<Scheduler::Stay> stays;
+    stays.reserve(ids.size() + 1);
+    for (int id : ids) {
+        const Reservation* r = reservations.get(findReservation(id));
+        stays.push_back({ r->getCheckInDay(), r->getCheckOutDay() });
+    }
+    if (withNewStay) {
+        stays.push_back({ from, to });
+        preferred.push_back(-1);
+    }
+
+    vector<int> assigned = Scheduler::partition(stays, releaseDays, preferred);
+    if (find(assigned.begin(), assigned.end(), -1) != assigned.end())
+        return result;
+
+    result.planned = true;
+    if (withNewStay) result.newStaySlot = slots[assigned.back()];
+
+    for (size_t k = 0; k < ids.size(); k++) {
+        if (assigned[k] != preferred[k]) {
+            result.moves.push_back({ ids[k], rooms[slots[preferred[k]]].getRoomNumber(),
+                rooms[slots[assigned[k]]].getRoomNumber() });
+        }
+    }
+    return result;
+}
+
+// Unlinks every move first, so a stay never lands in a room its previous
+// occupant has not left yet
+void HotelSystem::applyRoomMoves(const vector<Scheduler::RoomMove>& moves) {
+    if (moves.empty()) return;
+
+    vector<SlotMap<Reservation>::Handle> handles;
+    handles.reserve(moves.size());
+    for (auto& m : moves) handles.push_back(findReservation(m.reservationId));
+
+    for (auto& h : handles) {
+        const Reservation* r = reservations.get(h);
+        if (!r) continue;
+
+        Room* oldRoom = getRoomRef(r->getRoomNumber());
+        if (oldRoom) oldRoom->removeReservation(r->getId());
+        unlinkBooking(*r);
+    }
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        Reservation* r = reservations.get(handles[i]);
+        if (!r) continue;
+
+        const Scheduler::RoomMove& m = moves[i];
+        r->setRoomNumber(m.toRoom);
+        Room* target = getRoomRef(m.toRoom);
+        if (target) target->addReservation(r->getId());
+        linkBooking(*r);
+        markReservationDirty(*r);
+    }
+    roomsDirty = true;
+
+    // A few moves are journaled like any change (once all are applied, a
+    // record may trigger a checkpoint); a large plan checkpoints directly
+    if (moves.size() >= checkpointInterval) {
+        checkpoint();
+        return;
+    }
+
+    for (auto& h : handles) {
+        const Reservation* r = reservations.get(h);
+        if (r) autoSave(putReservationRecord(*r));
+    }
 }
 
 // ================================================================
@@ -0,0 +1,43 @@
+#include "Journal.h"
+
+#include <fstream>
+
+using namespace std;
+
+// ================================================================
+//                  APPEND RECORDS
+// ================================================================
+void Journal::appendBatch(const string& lines) {
+    ofstream f(path, ios::app | ios::binary);
+    f.write(lines.data(), static_cast<streamsize>(lines.size()));
+    f.flush();
+}
+
+// ================================================================
+//                  READ LOG TAIL (STARTUP REPLAY)
+// ================================================================
+vector<json> Journal::readAll() const {
+    vector<json> records;
+
+    ifstream f(path);
+    if (!f.good()) return records;
+
+    string line;
+    while (getline(f, line)) {
+        if (line.empty()) continue;
+
+        json j = json::parse(line, nullptr, false);
+        if (j.is_discarded()) break;   // torn write at the end of the log
+
+        records.push_back(j);
+    }
+
+    return records;
+}
+
+// ================================================================
+//                  TRUNCATE AFTER CHECKPOINT
+// ================================================================
+void Journal::truncate() {
+    ofstream f(path, ios::trunc);
+}
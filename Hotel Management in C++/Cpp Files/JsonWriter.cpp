@@ -0,0 +1,133 @@
+#include "JsonWriter.h"
+#include "json.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+// ================================================================
+//                  LAYOUT (COMMAS, NEWLINES, INDENT)
+// ================================================================
+void JsonWriter::clear() {
+    out.clear();
+    stack.clear();
+    afterKey = false;
+}
+
+void JsonWriter::newline(size_t depth) {
+    if (indent < 0) return;
+    out += '\n';
+    out.append(depth * static_cast<size_t>(indent), ' ');
+}
+
+// Separator and indentation in front of an array element or object key
+void JsonWriter::beforeValue() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (stack.empty()) return;
+
+    Level& level = stack.back();
+    if (level.count > 0) out += ',';
+    level.count++;
+    newline(stack.size());
+}
+
+void JsonWriter::beginArray() {
+    beforeValue();
+    out += '[';
+    stack.push_back({ true, 0 });
+}
+
+void JsonWriter::endArray() {
+    bool empty = stack.back().count == 0;
+    stack.pop_back();
+    if (!empty) newline(stack.size());
+    out += ']';
+}
+
+void JsonWriter::beginObject() {
+    beforeValue();
+    out += '{';
+    stack.push_back({ false, 0 });
+}
+
+void JsonWriter::endObject() {
+    bool empty = stack.back().count == 0;
+    stack.pop_back();
+    if (!empty) newline(stack.size());
+    out += '}';
+}
+
+void JsonWriter::key(const char* k) {
+    beforeValue();
+    out += '"';
+    out += k;
+    out += indent < 0 ? "\":" : "\": ";
+    afterKey = true;
+}
+
+// ================================================================
+//                  SCALARS
+// ================================================================
+void JsonWriter::value(int v) {
+    beforeValue();
+    out += to_string(v);
+}
+
+void JsonWriter::value(long long v) {
+    beforeValue();
+    out += to_string(v);
+}
+
+// Same shortest round-trip formatting (Grisu2) as json::dump
+void JsonWriter::value(double v) {
+    beforeValue();
+
+    if (!isfinite(v)) {
+        out += "null";
+        return;
+    }
+
+    char buffer[64];
+    char* end = nlohmann::detail::to_chars(buffer, buffer + sizeof buffer, v);
+    out.append(buffer, static_cast<size_t>(end - buffer));
+}
+
+void JsonWriter::value(const string& v) {
+    beforeValue();
+    out += '"';
+    escape(v);
+    out += '"';
+}
+
+void JsonWriter::value(const char* v) {
+    value(string(v));
+}
+
+// Escapes exactly like json::dump with ensure_ascii = false
+void JsonWriter::escape(const string& s) {
+    for (char ch : s) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        switch (c) {
+        case '\b': out += "\\b"; break;
+        case '\t': out += "\\t"; break;
+        case '\n': out += "\\n"; break;
+        case '\f': out += "\\f"; break;
+        case '\r': out += "\\r"; break;
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        default:
+            if (c <= 0x1F) {
+                char buffer[8];
+                snprintf(buffer, sizeof buffer, "\\u%04x", c);
+                out += buffer;
+            }
+            else {
+                out += ch;
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+#include "MappedReservations.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ================================================================
+//                  RECORD VIEW
+// ================================================================
+int ReservationView::field(size_t offset) const {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p + offset);
+    uint32_t v = b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24);
+    return static_cast<int>(v);
+}
+
+string ReservationView::text(size_t offset, size_t width) const {
+    const char* s = p + offset;
+    size_t n = 0;
+    while (n < width && s[n] != '\0') n++;
+    return string(s, n);
+}
+
+double ReservationView::getFinalPrice() const {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p + layout->finalPrice);
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) bits |= static_cast<uint64_t>(b[i]) << (8 * i);
+
+    double v;
+    memcpy(&v, &bits, sizeof v);
+    return v;
+}
+
+// ================================================================
+//                  MAP / UNMAP
+// ================================================================
+bool MappedReservations::open(const string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!base) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mapHandle = mapping;
+    length = static_cast<size_t>(size.QuadPart);
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close();
+        return false;
+    }
+
+    void* m = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (m == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    base = static_cast<const char*>(m);
+    length = static_cast<size_t>(st.st_size);
+#endif
+
+    uint32_t records, version;
+    if (!BinaryStore::checkHeader(base, length, BinaryStore::Reservations, records, version)) {
+        close();
+        return false;
+    }
+
+    layout = &BinaryStore::reservationLayout(version);
+    if (length != BinaryStore::HeaderSize + static_cast<size_t>(records) * layout->size + BinaryStore::TrailerSize) {
+        close();
+        return false;
+    }
+
+    count = records;
+    return true;
+}
+
+void MappedReservations::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mapHandle) CloseHandle(mapHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mapHandle = fileHandle = nullptr;
+#else
+    if (base) munmap(const_cast<char*>(base), length);
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+
+    base = nullptr;
+    length = 0;
+    count = 0;
+}
+
+bool MappedReservations::materialize(vector<Reservation>& out) const {
+    if (!base) return false;
+    return BinaryStore::decodeReservations(base, length, out);
+}
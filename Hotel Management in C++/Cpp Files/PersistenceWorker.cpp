@@ -0,0 +1,160 @@
+#include "PersistenceWorker.h"
+#include "AtomicFile.h"
+
+#include <iostream>
+#include <map>
+#include <filesystem>
+
+using namespace std;
+
+// ================================================================
+//                  START / STOP
+// ================================================================
+PersistenceWorker::PersistenceWorker(Journal& journal) : journal(journal) {
+    worker = thread(&PersistenceWorker::run, this);
+}
+
+// Drains everything still queued before the thread exits
+PersistenceWorker::~PersistenceWorker() {
+    {
+        lock_guard<mutex> lock(m);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+// ================================================================
+//                  QUEUEING (INTERACTIVE THREAD)
+// ================================================================
+void PersistenceWorker::appendRecord(string record) {
+    {
+        lock_guard<mutex> lock(m);
+        Job job;
+        job.record = std::move(record);
+        queue.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void PersistenceWorker::checkpoint(vector<SnapshotFile> files) {
+    {
+        lock_guard<mutex> lock(m);
+        Job job;
+        job.isCheckpoint = true;
+        job.files = std::move(files);
+        queue.push_back(std::move(job));
+    }
+    wake.notify_one();
+}
+
+void PersistenceWorker::flush() {
+    unique_lock<mutex> lock(m);
+    idle.wait(lock, [&] { return queue.empty() && !busy; });
+}
+
+// ================================================================
+//                  WORKER LOOP
+// ================================================================
+void PersistenceWorker::run() {
+    unique_lock<mutex> lock(m);
+
+    while (true) {
+        wake.wait(lock, [&] { return stopping || !queue.empty(); });
+        if (queue.empty()) break;   // stopping and fully drained
+
+        // Everything that piled up while the last batch was written
+        // becomes one group commit
+        deque<Job> batch;
+        batch.swap(queue);
+        busy = true;
+
+        lock.unlock();
+        writeBatch(batch);
+        lock.lock();
+
+        busy = false;
+        idle.notify_all();
+    }
+}
+
+void PersistenceWorker::writeBatch(deque<Job>& batch) {
+    // Records before the last checkpoint are already contained in it
+    size_t lastCheckpoint = batch.size();
+    for (size_t i = 0; i < batch.size(); i++)
+        if (batch[i].isCheckpoint) lastCheckpoint = i;
+
+    size_t firstRecord = 0;
+
+    if (lastCheckpoint < batch.size()) {
+        // Newest copy of each file wins; older checkpoints (and a failed
+        // one) may hold files the last one does not (only dirty
+        // collections are included). An append that follows a copy of
+        // the same file is written as part of that copy.
+        map<string, function<string()>> files;
+        vector<SnapshotFile> appends;
+        files.swap(unwritten);
+        appends.swap(unwrittenAppends);
+        for (size_t i = 0; i <= lastCheckpoint; i++)
+            for (auto& f : batch[i].files) {
+                auto copy = files.find(f.path);
+                if (f.append && copy != files.end())
+                    copy->second = [head = copy->second, tail = f.encode]() { return head() + tail(); };
+                else if (f.append) appends.push_back(f);
+                else files[f.path] = f.encode;
+            }
+
+        // Write + fsync every temp file, then rename them all and sync each
+        // directory once. The journal is only truncated when every file
+        // made it; otherwise the old snapshots plus the log stay valid.
+        // Appends go first: the files replaced next may stop holding what
+        // was appended.
+        bool ok = true;
+        size_t appended = 0;
+        while (ok && appended < appends.size()) {
+            const SnapshotFile& f = appends[appended];
+            ok = f.appendWith ? f.appendWith(f.encode()) : AtomicFile::append(f.path, f.encode());
+            if (ok) appended++;
+        }
+
+        for (auto& f : files) {
+            // An empty encoding means the data cannot be stored in this format
+            string bytes = f.second();
+            if (bytes.empty()) cerr << "Warning: could not encode " << f.first << ".\n";
+            ok = !bytes.empty() && AtomicFile::writeTemp(f.first, bytes) && ok;
+        }
+
+        if (ok) {
+            // One file per directory is enough to locate it
+            map<string, string> dirs;
+            for (auto& f : files) {
+                ok = AtomicFile::commit(f.first) && ok;
+                dirs[filesystem::path(f.first).parent_path().string()] = f.first;
+            }
+            for (auto& d : dirs)
+                AtomicFile::syncDirectory(d.second);
+        }
+
+        if (ok) {
+            journal.truncate();
+            firstRecord = lastCheckpoint + 1;
+        }
+        else {
+            // Old snapshots stay valid; keep every record of the batch and
+            // retry the files with the next checkpoint
+            unwrittenAppends.assign(appends.begin() + appended, appends.end());
+            unwritten = std::move(files);
+            cerr << "Warning: checkpoint failed, keeping the journal (retried at the next checkpoint).\n";
+        }
+    }
+
+    string lines;
+    for (size_t i = firstRecord; i < batch.size(); i++) {
+        if (batch[i].isCheckpoint) continue;
+        lines += batch[i].record;
+        lines += '\n';
+    }
+
+    if (!lines.empty())
+        journal.appendBatch(lines);
+}
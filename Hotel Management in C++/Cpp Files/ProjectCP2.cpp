@@ -1,10 +1,59 @@
 #include <iostream>
+#include <string>
 #include "HotelSystem.h"
+#include "StorageBenchmark.h"
+#include "CalendarBenchmark.h"
+#include "ArchiveCheck.h"
 
 using namespace std;
 
-int main() {
-    HotelSystem system;
+int main(int argc, char* argv[]) {
+    // --storage=NAME   : snapshot format (binary, json, cbor, msgpack)
+    // --benchmark      : compare the storage backends and exit
+    // --bench-calendar : compare the date functions with mktime and exit
+    // --check-archive  : tear and re-append a scratch archive, then exit
+    // --archive-days=N : archive stays that checked out more than N days
+    // ago (-1 disables the archive)
+    // --no-journal     : checkpoint after every change instead of logging it
+    string storage = "binary";
+    int archiveDays = 30;
+    bool journalMode = true;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--benchmark") {
+            StorageBenchmark::run();
+            return 0;
+        }
+        else if (arg == "--bench-calendar") {
+            CalendarBenchmark::run();
+            return 0;
+        }
+        else if (arg == "--check-archive") {
+            return ArchiveCheck::run() ? 0 : 1;
+        }
+        else if (arg.rfind("--storage=", 0) == 0) {
+            storage = arg.substr(10);
+            if (!StorageBackend::create(storage)) {
+                cout << "Unknown storage backend '" << storage << "'. Available:";
+                for (auto& name : StorageBackend::names()) cout << " " << name;
+                cout << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--no-journal") {
+            journalMode = false;
+        }
+        else if (arg.rfind("--archive-days=", 0) == 0) {
+            try {
+                archiveDays = stoi(arg.substr(15));
+            }
+            catch (...) {
+                cout << "Warning: invalid " << arg << ", using " << archiveDays << " days.\n";
+            }
+        }
+    }
+
+    HotelSystem system(storage, archiveDays, journalMode);
 
     int choice = -1;
 
@@ -0,0 +1,304 @@
+#include "ReservationArchive.h"
+#include "BinaryStore.h"
+#include "AtomicFile.h"
+#include "Calendar.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <filesystem>
+
+using namespace std;
+
+namespace {
+
+// ================================================================
+//                  VARINT WRITER / READER
+// ================================================================
+struct VarintWriter {
+    string& out;
+
+    void u64(uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    // Zigzag: small negative numbers stay short
+    void i64(int64_t v) { u64((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63)); }
+
+    void raw(uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++) out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+};
+
+struct VarintReader {
+    const char* p;
+    const char* end;
+    bool ok = true;
+
+    uint64_t u64() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) break;
+            unsigned char b = static_cast<unsigned char>(*p++);
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t i64() {
+        uint64_t v = u64();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    uint64_t raw(int bytes) {
+        if (end - p < bytes) {
+            ok = false;
+            return 0;
+        }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; i++) v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        p += bytes;
+        return v;
+    }
+};
+
+uint32_t readU32(const char* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    return v;
+}
+
+uint64_t readU64(const char* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    return v;
+}
+
+// Price as whole cents when that is exact, otherwise the raw double
+bool toCents(double price, uint64_t& cents) {
+    if (!(price >= 0) || price > 1e13) return false;
+    double c = round(price * 100);
+    if (c / 100 != price) return false;
+    cents = static_cast<uint64_t>(c);
+    return true;
+}
+
+} // namespace
+
+// ================================================================
+//                  ENCODE BLOCK
+// ================================================================
+bool ReservationArchive::isArchivable(const Reservation& r) {
+    return r.getCheckInDay() != Calendar::NoDay && r.getCheckOutDay() != Calendar::NoDay;
+}
+
+string ReservationArchive::encodeBlock(vector<Reservation> reservations) {
+    sort(reservations.begin(), reservations.end(),
+        [](const Reservation& a, const Reservation& b) { return a.getId() < b.getId(); });
+
+    string payload;
+    VarintWriter w{ payload };
+    BlockHeader h;
+    h.count = static_cast<uint32_t>(reservations.size());
+
+    int prevId = 0, prevCheckIn = 0;
+    for (size_t i = 0; i < reservations.size(); i++) {
+        const Reservation& r = reservations[i];
+        int checkIn = r.getCheckInDay(), checkOut = r.getCheckOutDay();
+
+        w.i64(static_cast<int64_t>(r.getId()) - prevId);
+        w.i64(r.getCustomerId());
+        w.i64(static_cast<int64_t>(checkIn) - prevCheckIn);
+        w.i64(static_cast<int64_t>(checkOut) - checkIn);
+        w.i64(r.getRoomNumber());
+        w.i64(r.getFloor());
+        w.u64(r.getRoomType().size());
+        payload.append(r.getRoomType());
+        w.i64(r.getNights());
+
+        uint64_t cents;
+        if (toCents(r.getFinalPrice(), cents)) {
+            w.u64(cents << 1);
+        }
+        else {
+            double price = r.getFinalPrice();
+            uint64_t bits;
+            memcpy(&bits, &price, sizeof bits);
+            w.u64(1);
+            w.raw(bits, 8);
+        }
+
+        prevId = r.getId();
+        prevCheckIn = checkIn;
+
+        h.maxId = i == 0 ? r.getId() : max(h.maxId, r.getId());
+        h.minCustomerId = i == 0 ? r.getCustomerId() : min(h.minCustomerId, r.getCustomerId());
+        h.maxCustomerId = i == 0 ? r.getCustomerId() : max(h.maxCustomerId, r.getCustomerId());
+    }
+
+    string out;
+    out.reserve(BlockHeaderSize + payload.size());
+    VarintWriter header{ out };
+    out.append("HTLA", 4);
+    header.raw(h.count, 4);
+    header.raw(payload.size(), 4);
+    header.raw(static_cast<uint32_t>(h.maxId), 4);
+    header.raw(static_cast<uint32_t>(h.minCustomerId), 4);
+    header.raw(static_cast<uint32_t>(h.maxCustomerId), 4);
+    header.raw(BinaryStore::checksum(payload.data(), payload.size()), 8);
+    out.append(payload);
+    return out;
+}
+
+// ================================================================
+//                  READ BLOCKS
+// ================================================================
+static bool decodeBlock(const string& payload, uint32_t count, vector<Reservation>& out) {
+    VarintReader r{ payload.data(), payload.data() + payload.size() };
+
+    int64_t id = 0, checkIn = 0;
+    for (uint32_t i = 0; i < count && r.ok; i++) {
+        id += r.i64();
+        int customerId = static_cast<int>(r.i64());
+        checkIn += r.i64();
+        int64_t checkOut = checkIn + r.i64();
+        int roomNumber = static_cast<int>(r.i64());
+        int floor = static_cast<int>(r.i64());
+
+        uint64_t typeLength = r.u64();
+        if (!r.ok || static_cast<uint64_t>(r.end - r.p) < typeLength) return false;
+        string roomType(r.p, static_cast<size_t>(typeLength));
+        r.p += typeLength;
+
+        int nights = static_cast<int>(r.i64());
+
+        double price;
+        uint64_t tag = r.u64();
+        if (tag & 1) {
+            uint64_t bits = r.raw(8);
+            memcpy(&price, &bits, sizeof price);
+        }
+        else {
+            price = static_cast<double>(tag >> 1) / 100;
+        }
+
+        if (!r.ok) return false;
+        out.emplace_back(static_cast<int>(id), customerId,
+            static_cast<int>(checkIn), static_cast<int>(checkOut),
+            roomNumber, floor, roomType, nights, price);
+    }
+
+    return r.ok && r.p == r.end;
+}
+
+void ReservationArchive::forEach(const function<bool(const BlockHeader&)>& wantBlock,
+    const function<void(const Reservation&)>& visit) const {
+    ifstream f(path, ios::binary);
+    if (!f.good()) return;
+
+    unordered_set<int> seen;
+    char raw[BlockHeaderSize];
+
+    while (f.read(raw, BlockHeaderSize)) {
+        if (memcmp(raw, "HTLA", 4) != 0) {
+            cout << "Warning: " << path << " has a damaged block, the rest is ignored.\n";
+            return;
+        }
+
+        BlockHeader h;
+        h.count = readU32(raw + 4);
+        h.payloadSize = readU32(raw + 8);
+        h.maxId = static_cast<int>(readU32(raw + 12));
+        h.minCustomerId = static_cast<int>(readU32(raw + 16));
+        h.maxCustomerId = static_cast<int>(readU32(raw + 20));
+        h.checksum = readU64(raw + 24);
+
+        if (!wantBlock(h)) {
+            if (!f.seekg(h.payloadSize, ios::cur)) return;
+            continue;
+        }
+
+        string payload(h.payloadSize, '\0');
+        if (!f.read(&payload[0], static_cast<streamsize>(payload.size())))
+            return;   // torn block at the end of the file
+
+        vector<Reservation> block;
+        if (BinaryStore::checksum(payload.data(), payload.size()) != h.checksum ||
+            !decodeBlock(payload, h.count, block)) {
+            cout << "Warning: " << path << " has a damaged block, the rest is ignored.\n";
+            return;
+        }
+
+        for (auto& r : block)
+            if (seen.insert(r.getId()).second) visit(r);
+    }
+}
+
+void ReservationArchive::forEach(const function<void(const Reservation&)>& visit) const {
+    forEach([](const BlockHeader&) { return true; }, visit);
+}
+
+void ReservationArchive::forCustomer(int customerId, const function<void(const Reservation&)>& visit) const {
+    forEach(
+        [&](const BlockHeader& h) { return customerId >= h.minCustomerId && customerId <= h.maxCustomerId; },
+        [&](const Reservation& r) { if (r.getCustomerId() == customerId) visit(r); });
+}
+
+bool ReservationArchive::hasCustomer(int customerId) const {
+    bool found = false;
+    forCustomer(customerId, [&](const Reservation&) { found = true; });
+    return found;
+}
+
+// ================================================================
+//                  APPEND
+// ================================================================
+size_t ReservationArchive::validLength() const {
+    ifstream f(path, ios::binary);
+    if (!f.good()) return 0;
+
+    size_t valid = 0;
+    char raw[BlockHeaderSize];
+    while (f.read(raw, BlockHeaderSize) && memcmp(raw, "HTLA", 4) == 0) {
+        string payload(readU32(raw + 8), '\0');
+        if (!f.read(&payload[0], static_cast<streamsize>(payload.size()))) break;
+        if (BinaryStore::checksum(payload.data(), payload.size()) != readU64(raw + 24)) break;
+
+        valid += BlockHeaderSize + payload.size();
+    }
+    return valid;
+}
+
+bool ReservationArchive::append(const string& block) const {
+    error_code ec;
+    uintmax_t size = filesystem::file_size(path, ec);
+    if (!ec) {
+        size_t valid = validLength();
+        if (valid < size) {
+            cout << "Warning: " << path << " ends with a damaged block (" << size - valid
+                << " bytes), cut off before appending.\n";
+            filesystem::resize_file(path, valid, ec);
+            if (ec) return false;
+        }
+    }
+    return AtomicFile::append(path, block);
+}
+
+int ReservationArchive::maxId() const {
+    int id = 0;
+    forEach([&](const BlockHeader& h) {
+        if (h.count > 0) id = max(id, h.maxId);
+        return false;
+    }, [](const Reservation&) {});
+    return id;
+}
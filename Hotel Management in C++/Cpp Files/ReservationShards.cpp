@@ -0,0 +1,86 @@
+#include "ReservationShards.h"
+
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+static const char* const ManifestHeader = "HTLM 1";
+
+bool ReservationShards::isMonth(const string& month) {
+    if (month == Undated) return true;
+
+    // [-]Y...Y-MM
+    size_t n = month.size();
+    if (n < 4 || month[n - 3] != '-') return false;
+    size_t start = month[0] == '-' ? 1 : 0;
+    if (start >= n - 3) return false;
+    for (size_t i = start; i < n; i++)
+        if (i != n - 3 && !isdigit(static_cast<unsigned char>(month[i]))) return false;
+    return true;
+}
+
+// ================================================================
+//                  READ MANIFEST
+// ================================================================
+bool ReservationShards::readManifest(const string& dir, vector<ReservationShard>& out, string& error) {
+    out.clear();
+
+    ifstream f(manifestPath(dir));
+    if (!f.good()) {
+        error = "cannot be opened";
+        return false;
+    }
+
+    string line;
+    if (!getline(f, line) || line != ManifestHeader) {
+        error = "bad header";
+        return false;
+    }
+
+    while (getline(f, line)) {
+        if (line.empty()) continue;
+
+        istringstream in(line);
+        ReservationShard s;
+        if (!(in >> s.month >> s.count >> s.maxId) || !isMonth(s.month)) {
+            error = "bad line \"" + line + "\"";
+            out.clear();
+            return false;
+        }
+
+        out.push_back(s);
+    }
+
+    return true;
+}
+
+vector<string> ReservationShards::listShards(const string& dir) {
+    vector<string> months;
+
+    error_code ec;
+    for (filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const filesystem::path& p = it->path();
+        if (p.extension() == ".bin" && isMonth(p.stem().string()))
+            months.push_back(p.stem().string());
+    }
+
+    sort(months.begin(), months.end());
+    return months;
+}
+
+// ================================================================
+//                  WRITE MANIFEST
+// ================================================================
+string ReservationShards::encodeManifest(const vector<ReservationShard>& shards) {
+    ostringstream out;
+    out << ManifestHeader << "\n";
+
+    for (auto& s : shards)
+        out << s.month << " " << s.count << " " << s.maxId << "\n";
+
+    return out.str();
+}
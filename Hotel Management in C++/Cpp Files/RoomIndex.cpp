@@ -0,0 +1,29 @@
+#include "RoomIndex.h"
+
+using namespace std;
+
+// ================================================================
+//                  BUILD
+// ================================================================
+void RoomIndex::build(const vector<Room>& rooms) {
+    buckets.clear();
+    overflow.clear();
+
+    for (size_t i = 0; i < rooms.size(); i++) {
+        int number = rooms[i].getRoomNumber();
+        int slot = static_cast<int>(i);
+
+        if (number < 0 || number >= MaxDirect) {
+            overflow.emplace(number, slot);
+            continue;
+        }
+
+        size_t bucket = static_cast<size_t>(number / BucketWidth);
+        if (bucket >= buckets.size()) buckets.resize(bucket + 1);
+        if (buckets[bucket].empty()) buckets[bucket].assign(BucketWidth, -1);
+
+        // First room wins if a number appears twice (like the old scan)
+        int& entry = buckets[bucket][number % BucketWidth];
+        if (entry < 0) entry = slot;
+    }
+}
@@ -0,0 +1,280 @@
+#include "SaxLoader.h"
+
+#include <stdexcept>
+#include <fstream>
+#include <cctype>
+
+using namespace std;
+
+// ================================================================
+//                  SAX RECORD ACCESSORS
+// ================================================================
+void SaxRecord::clear() {
+    ints.clear();
+    doubles.clear();
+    strings.clear();
+    intLists.clear();
+    stringLists.clear();
+}
+
+int SaxRecord::getInt(const std::string& key) const {
+    auto it = ints.find(key);
+    if (it == ints.end()) throw out_of_range("missing field '" + key + "'");
+    return static_cast<int>(it->second);
+}
+
+const std::string& SaxRecord::getString(const std::string& key) const {
+    auto it = strings.find(key);
+    if (it == strings.end()) throw out_of_range("missing field '" + key + "'");
+    return it->second;
+}
+
+double SaxRecord::getDouble(const std::string& key) const {
+    auto d = doubles.find(key);
+    if (d != doubles.end()) return d->second;
+
+    // Whole numbers such as 150 arrive as integers
+    auto i = ints.find(key);
+    if (i != ints.end()) return static_cast<double>(i->second);
+
+    throw out_of_range("missing field '" + key + "'");
+}
+
+int SaxRecord::getInt(const std::string& key, int def) const {
+    auto it = ints.find(key);
+    return it == ints.end() ? def : static_cast<int>(it->second);
+}
+
+double SaxRecord::getDouble(const std::string& key, double def) const {
+    if (!doubles.count(key) && !ints.count(key)) return def;
+    return getDouble(key);
+}
+
+// ================================================================
+//                  SAX EVENTS
+// ================================================================
+// depth 1 = top-level array, depth 2 = one record, depth 3 = a list
+// inside the record. Scalars are only kept at depth 2 and 3.
+void RecordSax::setInt(long long v) {
+    if (inList && depth == 3) record.intLists[currentKey].push_back(v);
+    else if (depth == 2) record.ints[currentKey] = v;
+}
+
+void RecordSax::setDouble(double v) {
+    if (depth == 2 && !inList) record.doubles[currentKey] = v;
+}
+
+bool RecordSax::null() { return true; }
+
+bool RecordSax::boolean(bool val) {
+    setInt(val ? 1 : 0);
+    return true;
+}
+
+bool RecordSax::number_integer(number_integer_t val) {
+    setInt(val);
+    return true;
+}
+
+bool RecordSax::number_unsigned(number_unsigned_t val) {
+    setInt(static_cast<long long>(val));
+    return true;
+}
+
+bool RecordSax::number_float(number_float_t val, const string_t&) {
+    setDouble(val);
+    return true;
+}
+
+bool RecordSax::string(string_t& val) {
+    if (inList && depth == 3) record.stringLists[currentKey].push_back(std::move(val));
+    else if (depth == 2) record.strings[currentKey] = std::move(val);
+    return true;
+}
+
+bool RecordSax::binary(binary_t&) { return true; }
+
+bool RecordSax::start_object(std::size_t) {
+    depth++;
+    if (depth == 1) return false;   // top level must be an array
+    if (depth == 2) record.clear();
+    return true;
+}
+
+bool RecordSax::key(string_t& val) {
+    if (depth == 2) currentKey = std::move(val);
+    return true;
+}
+
+bool RecordSax::end_object() {
+    if (depth == 2) onRecord(record);
+    depth--;
+    return true;
+}
+
+bool RecordSax::start_array(std::size_t) {
+    depth++;
+    if (depth == 3) {
+        inList = true;
+        // An empty list must still be present after the record is built
+        record.intLists[currentKey];
+        record.stringLists[currentKey];
+    }
+    return true;
+}
+
+bool RecordSax::end_array() {
+    if (depth == 3) inList = false;
+    depth--;
+    return true;
+}
+
+bool RecordSax::parse_error(std::size_t, const std::string&,
+    const nlohmann::detail::exception&) {
+    return false;
+}
+
+// ================================================================
+//                  TORN FILE CHECK
+// ================================================================
+bool isCompleteJSONArray(const std::string& path) {
+    ifstream f(path, ios::binary | ios::ate);
+    if (!f.good()) return false;
+
+    streamoff size = f.tellg();
+    if (size < 2) return false;
+
+    // Last non-blank byte, scanning backwards from the end
+    char last = 0;
+    for (streamoff pos = size - 1; pos >= 0; pos--) {
+        f.seekg(pos);
+        char c = static_cast<char>(f.get());
+        if (!isspace(static_cast<unsigned char>(c))) {
+            last = c;
+            break;
+        }
+    }
+
+    // First non-blank byte
+    f.seekg(0);
+    char first = 0;
+    while (f.get(first) && isspace(static_cast<unsigned char>(first))) {}
+
+    return first == '[' && last == ']';
+}
+
+// ================================================================
+//                  RECORD -> DOMAIN OBJECTS
+// ================================================================
+// A missing required field throws out_of_range from the record getters;
+// it fails the parse like a syntax error
+static bool parseRecords(istream& in, function<void(const SaxRecord&)> onRecord) {
+    RecordSax sax(std::move(onRecord));
+    try {
+        return json::sax_parse(in, &sax);
+    }
+    catch (const exception&) {
+        return false;
+    }
+}
+
+static bool parseRecords(const std::string& bytes, input_format format,
+    function<void(const SaxRecord&)> onRecord) {
+    RecordSax sax(std::move(onRecord));
+    try {
+        return json::sax_parse(bytes, &sax, format);
+    }
+    catch (const exception&) {
+        return false;
+    }
+}
+
+// All or nothing: when the parse fails, the records added before the
+// error are removed again, so a damaged file never passes for a short one
+template <class T, class Parse>
+static bool parseAll(vector<T>& out, Parse parse) {
+    size_t before = out.size();
+    if (parse()) return true;
+
+    out.erase(out.begin() + before, out.end());
+    return false;
+}
+
+static void addCustomer(const SaxRecord& r, vector<Customer>& out) {
+    out.emplace_back(
+        r.getInt("id"),
+        r.getString("name"),
+        r.getString("phone"),
+        r.getString("email"),
+        r.getInt("totalBookings", 0)
+    );
+}
+
+static void addReservation(const SaxRecord& r, vector<Reservation>& out) {
+    out.emplace_back(
+        r.getInt("id"),
+        r.getInt("customerId"),
+        r.getString("checkIn"),
+        r.getString("checkOut"),
+        r.getInt("roomNumber"),
+        r.getInt("floor"),
+        r.getString("roomType"),
+        r.getInt("nights", 0),
+        r.getDouble("finalPrice", 0.0)
+    );
+}
+
+static void addRoom(const SaxRecord& r, vector<Room>& out) {
+    Room room(
+        r.getInt("roomNumber"),
+        r.getInt("floor"),
+        r.getString("type"),
+        r.getDouble("price")
+    );
+
+    auto comments = r.stringLists.find("comments");
+    if (comments != r.stringLists.end())
+        for (auto& c : comments->second) room.addComment(c);
+
+    auto ids = r.intLists.find("reservationIds");
+    if (ids != r.intLists.end())
+        for (long long id : ids->second) room.addReservation(static_cast<int>(id));
+
+    out.push_back(std::move(room));
+}
+
+bool loadCustomersSax(istream& in, vector<Customer>& out) {
+    return parseAll(out, [&]() {
+        return parseRecords(in, [&](const SaxRecord& r) { addCustomer(r, out); });
+    });
+}
+
+bool loadReservationsSax(istream& in, vector<Reservation>& out) {
+    return parseAll(out, [&]() {
+        return parseRecords(in, [&](const SaxRecord& r) { addReservation(r, out); });
+    });
+}
+
+bool loadRoomsSax(istream& in, vector<Room>& out) {
+    return parseAll(out, [&]() {
+        return parseRecords(in, [&](const SaxRecord& r) { addRoom(r, out); });
+    });
+}
+
+bool loadCustomersSax(const std::string& bytes, input_format format, vector<Customer>& out) {
+    return parseAll(out, [&]() {
+        return parseRecords(bytes, format, [&](const SaxRecord& r) { addCustomer(r, out); });
+    });
+}
+
+bool loadReservationsSax(const std::string& bytes, input_format format, vector<Reservation>& out) {
+    return parseAll(out, [&]() {
+        return parseRecords(bytes, format, [&](const SaxRecord& r) { addReservation(r, out); });
+    });
+}
+
+bool loadRoomsSax(const std::string& bytes, input_format format, vector<Room>& out) {
+    return parseAll(out, [&]() {
+        return parseRecords(bytes, format, [&](const SaxRecord& r) { addRoom(r, out); });
+    });
+}
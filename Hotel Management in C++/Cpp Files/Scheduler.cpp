@@ -1,61 +1,494 @@
 #include "Scheduler.h"
 #include <algorithm>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <string>
+#include <unordered_map>
+#include <set>
+#include <atomic>
+#include <future>
+#include <thread>
 
 using namespace std;
 
-// Helper: Check if this room can take the reservation (no overlaps)
-static bool roomIsFreeFor(const Room& room, const Reservation& res,
-    const vector<Reservation>& reservations) {
+// ================================================================
+//                  INTERVAL PARTITIONING
+// ================================================================
+// A room is only opened when every opened room is still occupied, so
+// the rooms used never exceed the peak overlap; taking the preferred
+// room instead of the heap top does not change that (any free room
+// will do), it only avoids needless moves.
+vector<int> Scheduler::partition(const vector<Stay>& stays, const vector<int>& releaseDays,
+    const vector<int>& preferred) {
 
-    for (int rId : room.getReservationIds()) {
-        for (const Reservation& existing : reservations) {
-            if (existing.getId() == rId) {
-                if (existing.overlaps(res)) {
-                    return false; // conflict
-                }
+    vector<int> order(stays.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return stays[a].checkIn < stays[b].checkIn; });
+
+    // (free-from day, room), earliest first; entries go stale when a
+    // preferred room is taken out of turn
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> busy;
+    vector<int> freeDay(releaseDays);
+    for (size_t r = 0; r < freeDay.size(); r++)
+        if (freeDay[r] != Unused) busy.push({ freeDay[r], static_cast<int>(r) });
+    size_t nextUnused = 0;
+
+    vector<int> assigned(stays.size(), -1);
+    for (int i : order) {
+        const Stay& s = stays[i];
+
+        int room = -1;
+        int want = preferred.empty() ? -1 : preferred[i];
+        if (want >= 0 && static_cast<size_t>(want) < freeDay.size() &&
+            (freeDay[want] == Unused || freeDay[want] <= s.checkIn)) {
+            room = want;
+        }
+        else {
+            while (!busy.empty() && busy.top().first != freeDay[busy.top().second])
+                busy.pop();
+
+            if (!busy.empty() && busy.top().first <= s.checkIn) {
+                room = busy.top().second;
+                busy.pop();
+            }
+            else {
+                while (nextUnused < freeDay.size() && freeDay[nextUnused] != Unused) nextUnused++;
+                if (nextUnused < freeDay.size()) room = static_cast<int>(nextUnused);
             }
         }
+
+        if (room < 0) continue;   // overbooked
+
+        assigned[i] = room;
+        freeDay[room] = max(s.checkOut, s.checkIn);
+        busy.push({ freeDay[room], room });
     }
-    return true;
+
+    return assigned;
 }
 
-void Scheduler::allocateRooms(vector<Reservation>& reservations, vector<Room>& rooms) {
-    // Sort reservations by check-in date
-    sort(reservations.begin(), reservations.end(),
-        [](const Reservation& a, const Reservation& b) {
-            if (a.getCustomerId() == b.getCustomerId())
-                return a.getCheckIn() < b.getCheckIn();
-            return a.getCustomerId() < b.getCustomerId();
+// ================================================================
+//                  GROUPING BY TYPE
+// ================================================================
+Scheduler::Grouping Scheduler::group(const vector<Reservation>& reservations, const vector<Room>& rooms,
+    int pinBefore) {
+
+    Grouping g;
+    g.typeOf.assign(reservations.size(), -1);
+    g.currentRoom.assign(reservations.size(), -1);
+    g.assignedRoom.assign(reservations.size(), -1);
+
+    // Rooms of each type, types in room order
+    vector<string> types;
+    unordered_map<int, int> slotOfNumber;       // room number -> slot in rooms
+    vector<int> indexInType(rooms.size());
+    for (size_t i = 0; i < rooms.size(); i++) {
+        auto it = find(types.begin(), types.end(), rooms[i].getType());
+        if (it == types.end()) {
+            types.push_back(rooms[i].getType());
+            g.types.emplace_back();
+            it = types.end() - 1;
+        }
+        TypePlan& plan = g.types[it - types.begin()];
+        slotOfNumber.emplace(rooms[i].getRoomNumber(), static_cast<int>(i));
+        indexInType[i] = static_cast<int>(plan.rooms.size());
+        plan.rooms.push_back(static_cast<int>(i));
+    }
+    for (auto& plan : g.types) plan.releaseDays.assign(plan.rooms.size(), Unused);
+
+    for (size_t i = 0; i < reservations.size(); i++) {
+        const Reservation& res = reservations[i];
+        auto it = find(types.begin(), types.end(), res.getRoomType());
+        if (it == types.end()) continue;   // no room of this type in the hotel
+
+        int t = static_cast<int>(it - types.begin());
+        TypePlan& plan = g.types[t];
+        g.typeOf[i] = t;
+
+        auto known = slotOfNumber.find(res.getRoomNumber());
+        if (known != slotOfNumber.end() && rooms[known->second].getType() == types[t])
+            g.currentRoom[i] = indexInType[known->second];
+
+        // Stays that already started stay where they are and hold their
+        // room until they check out
+        int current = g.currentRoom[i];
+        if (current >= 0 && res.getCheckInDay() < pinBefore) {
+            g.assignedRoom[i] = current;
+            plan.releaseDays[current] = max(plan.releaseDays[current], res.getCheckOutDay());
+            continue;
+        }
+
+        plan.movable.push_back(static_cast<int>(i));
+    }
+
+    for (auto& plan : g.types) {
+        stable_sort(plan.movable.begin(), plan.movable.end(), [&](int a, int b) {
+            return reservations[a].getCheckInDay() < reservations[b].getCheckInDay();
         });
+    }
+    return g;
+}
+
+// Unknown type, or more overlapping stays than rooms of the type: -1
+vector<int> Scheduler::roomNumbers(const Grouping& g, const vector<Room>& rooms) {
+    vector<int> numbers(g.typeOf.size(), -1);
+    for (size_t i = 0; i < numbers.size(); i++) {
+        if (g.typeOf[i] >= 0 && g.assignedRoom[i] >= 0)
+            numbers[i] = rooms[g.types[g.typeOf[i]].rooms[g.assignedRoom[i]]].getRoomNumber();
+    }
+    return numbers;
+}
+
+// ================================================================
+//                  FULL PLAN
+// ================================================================
+// Room types never share rooms, and within a type two groups of stays
+// whose date spans do not overlap cannot affect each other (the rooms
+// are in the same state at the start of each: free, or held by a pinned
+// stay). Each such component is an independent task; large inputs run
+// the tasks on worker threads. Every task writes only the entries of its
+// own stays, so the result does not depend on the number of threads.
+vector<int> Scheduler::planRooms(const vector<Reservation>& reservations, const vector<Room>& rooms,
+    int pinBefore) {
+    struct Task {
+        const TypePlan* type;
+        vector<int> members;        // positions in reservations
+    };
+
+    Grouping g = group(reservations, rooms, pinBefore);
+
+    // Split each type into components of overlapping stays
+    vector<Task> tasks;
+    for (auto& plan : g.types) {
+        int spanEnd = INT_MIN;
+        for (int i : plan.movable) {
+            const Reservation& res = reservations[i];
+            if (tasks.empty() || tasks.back().type != &plan || res.getCheckInDay() >= spanEnd)
+                tasks.push_back({ &plan, {} });
+
+            tasks.back().members.push_back(i);
+            spanEnd = max(spanEnd, max(res.getCheckOutDay(), res.getCheckInDay() + 1));
+        }
+    }
+
+    auto runTask = [&](const Task& task) {
+        vector<Stay> stays;
+        vector<int> wanted;
+        stays.reserve(task.members.size());
+        wanted.reserve(task.members.size());
+        for (int i : task.members) {
+            stays.push_back({ reservations[i].getCheckInDay(), reservations[i].getCheckOutDay() });
+            wanted.push_back(g.currentRoom[i]);
+        }
+
+        vector<int> assigned = partition(stays, task.type->releaseDays, wanted);
+        for (size_t k = 0; k < task.members.size(); k++)
+            g.assignedRoom[task.members[k]] = assigned[k];
+    };
+
+    size_t workers = min<size_t>(tasks.size(), max(1u, thread::hardware_concurrency()));
+    if (reservations.size() < ParallelThreshold || workers <= 1) {
+        for (auto& task : tasks) runTask(task);
+    }
+    else {
+        // Largest components first so no worker is left with a big one at the end
+        vector<size_t> order(tasks.size());
+        iota(order.begin(), order.end(), 0);
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return tasks[a].members.size() > tasks[b].members.size();
+        });
+
+        atomic<size_t> next{ 0 };
+        vector<future<void>> pool;
+        for (size_t w = 0; w < workers; w++) {
+            pool.push_back(async(launch::async, [&]() {
+                for (size_t k; (k = next.fetch_add(1)) < order.size();)
+                    runTask(tasks[order[k]]);
+            }));
+        }
+        for (auto& f : pool) f.get();
+    }
+
+    return roomNumbers(g, rooms);
+}
+
+// Only the planned room numbers are new; the reservations themselves are
+// read in place, so a dry run costs no copy of the data
+vector<Scheduler::RoomMove> Scheduler::planMoves(const vector<Reservation>& reservations,
+    const vector<Room>& rooms, int pinBefore) {
+
+    return movesTo(reservations, planRooms(reservations, rooms, pinBefore));
+}
+
+vector<Scheduler::RoomMove> Scheduler::movesTo(const vector<Reservation>& reservations,
+    const vector<int>& planned) {
+
+    vector<RoomMove> moves;
+    for (size_t i = 0; i < reservations.size(); i++) {
+        if (planned[i] != reservations[i].getRoomNumber())
+            moves.push_back({ reservations[i].getId(), reservations[i].getRoomNumber(), planned[i] });
+    }
+    return moves;
+}
+
+// ================================================================
+//                  COMPACT PLAN (FEWER SHORT GAPS)
+// ================================================================
+// The helpers work on the movable stays of one type, in check-in order,
+// and a room index per stay (-1 = not placed).
 
-    // Clear previous room assignment lists
-    for (auto& r : rooms) {
-        r.clearReservations();
+// Stranded nights of a plan, pinned stays included through releaseDays
+static long long strandedTotal(const vector<Scheduler::Stay>& stays, const vector<int>& room,
+    const vector<int>& releaseDays) {
+
+    vector<int> lastOut(releaseDays);
+    long long total = 0;
+    for (size_t k = 0; k < stays.size(); k++) {
+        int r = room[k];
+        if (r < 0) continue;
+
+        total += Scheduler::strandedNights(lastOut[r], stays[k].checkIn);
+        lastOut[r] = max(lastOut[r], stays[k].checkOut);
     }
+    return total;
+}
 
-    // Try to assign each reservation to a room
-    for (auto& res : reservations) {
+static size_t unplacedCount(const vector<int>& room) {
+    return static_cast<size_t>(count(room.begin(), room.end(), -1));
+}
 
-        bool placed = false;
+// No two placed stays of a room overlap, nor overlap its pinned stays
+static bool fits(const vector<Scheduler::Stay>& stays, const vector<int>& room,
+    const vector<int>& releaseDays) {
+
+    vector<int> lastOut(releaseDays);
+    for (size_t k = 0; k < stays.size(); k++) {
+        int r = room[k];
+        if (r < 0) continue;
+        if (lastOut[r] != Scheduler::Unused && stays[k].checkIn < lastOut[r]) return false;
+        lastOut[r] = max(stays[k].checkOut, stays[k].checkIn);
+    }
+    return true;
+}
 
-        for (auto& room : rooms) {
+// Baseline: each stay in the first room (room order) that is free
+static vector<int> firstFit(const vector<Scheduler::Stay>& stays, const vector<int>& releaseDays) {
+    vector<int> freeDay(releaseDays);
+    vector<int> room(stays.size(), -1);
+    for (size_t k = 0; k < stays.size(); k++) {
+        for (size_t r = 0; r < freeDay.size(); r++) {
+            if (freeDay[r] == Scheduler::Unused || freeDay[r] <= stays[k].checkIn) {
+                room[k] = static_cast<int>(r);
+                freeDay[r] = max(stays[k].checkOut, stays[k].checkIn);
+                break;
+            }
+        }
+    }
+    return room;
+}
 
-            // Room type must match reservation
-            if (room.getType() != res.getRoomType())
-                continue;
+// Each stay goes to the free room whose last stay ended latest (the
+// tightest fit); if that leaves a short gap, to the latest room that
+// leaves a sellable one, or to an unused room. Any free room keeps the
+// plan feasible, so this places as many stays as partition. A stay
+// keeps its current room when that is free and strands no more nights.
+static vector<int> bestFit(const vector<Scheduler::Stay>& stays, const vector<int>& releaseDays,
+    const vector<int>& current) {
 
-            // Check for overlap
-            if (roomIsFreeFor(room, res, reservations)) {
-                res.setRoomNumber(room.getRoomNumber());
-                room.addReservation(res.getId());
-                placed = true;
+    set<pair<int, int>> freeFrom;      // (free from day, room) of the rooms in use
+    vector<int> freeDay(releaseDays);
+    vector<bool> used(releaseDays.size(), false);
+    for (size_t r = 0; r < releaseDays.size(); r++) {
+        if (releaseDays[r] == Scheduler::Unused) continue;
+        freeFrom.insert({ releaseDays[r], static_cast<int>(r) });
+        used[r] = true;
+    }
+    size_t nextUnused = 0;
+
+    auto latestFreeBy = [&](int day) {
+        auto it = freeFrom.upper_bound({ day, INT_MAX });
+        return it == freeFrom.begin() ? freeFrom.end() : prev(it);
+    };
+
+    vector<int> room(stays.size(), -1);
+    for (size_t k = 0; k < stays.size(); k++) {
+        const Scheduler::Stay& s = stays[k];
+        while (nextUnused < used.size() && used[nextUnused]) nextUnused++;
+
+        auto it = latestFreeBy(s.checkIn);
+        if (it != freeFrom.end() && Scheduler::strandedNights(it->first, s.checkIn) > 0) {
+            auto wide = latestFreeBy(s.checkIn - Scheduler::SellableGap);
+            if (wide != freeFrom.end()) it = wide;
+            else if (nextUnused < used.size()) it = freeFrom.end();
+        }
+
+        int r = current[k];
+        int lost = it != freeFrom.end() ? Scheduler::strandedNights(it->first, s.checkIn) : 0;
+        bool keep = r >= 0 && (freeDay[r] == Scheduler::Unused || freeDay[r] <= s.checkIn) &&
+            Scheduler::strandedNights(freeDay[r], s.checkIn) <= lost;
+
+        if (keep) {
+            if (used[r]) freeFrom.erase({ freeDay[r], r });
+            used[r] = true;
+        }
+        else if (it != freeFrom.end()) {
+            r = it->second;
+            freeFrom.erase(it);
+        }
+        else if (nextUnused < used.size()) {
+            r = static_cast<int>(nextUnused);
+            used[r] = true;
+        }
+        else {
+            continue;   // overbooked
+        }
+
+        room[k] = r;
+        freeDay[r] = max(s.checkOut, s.checkIn);
+        freeFrom.insert({ freeDay[r], r });
+    }
+    return room;
+}
+
+// Local search: for a short gap of room a, find a gap of room b such
+// that a's stays after its gap fit after b's gap and the other way
+// round, and swap the two tails when fewer nights are stranded. Only the
+// two gaps change, every swap strictly lowers the total, so the search
+// ends; it also stops at the deadline (returns true then). Of the swaps
+// that gain the most, the one that puts the most stays back in their
+// current room wins.
+static bool swapTails(const vector<Scheduler::Stay>& stays, const vector<int>& releaseDays,
+    const vector<int>& current, vector<int>& room, chrono::steady_clock::time_point deadline,
+    size_t& swaps) {
+
+    size_t rooms = releaseDays.size();
+    vector<vector<int>> seq(rooms);            // stays of each room, by check-in
+    for (size_t k = 0; k < stays.size(); k++)
+        if (room[k] >= 0) seq[room[k]].push_back(static_cast<int>(k));
+
+    // Gap before position p of room r: [end of the previous stay, start of the next)
+    auto gapFrom = [&](size_t r, size_t p) {
+        return p == 0 ? releaseDays[r] : stays[seq[r][p - 1]].checkOut;
+    };
+    auto gapTo = [&](size_t r, size_t p) {
+        return p == seq[r].size() ? INT_MAX : stays[seq[r][p]].checkIn;
+    };
+    // Stays of room r from position p on that are in room to afterwards
+    // and were not before: + for each one moving home, - for each leaving
+    auto settled = [&](size_t r, size_t p, size_t to) {
+        int n = 0;
+        for (size_t i = p; i < seq[r].size(); i++) {
+            int home = current[seq[r][i]];
+            n += (home == static_cast<int>(to)) - (home == static_cast<int>(r));
+        }
+        return n;
+    };
+
+    bool budgetUsedUp = false;
+    bool improved = true;
+    while (improved && !budgetUsedUp) {
+        improved = false;
+        for (size_t a = 0; a < rooms; a++) {
+            if (chrono::steady_clock::now() >= deadline) {
+                budgetUsedUp = true;
                 break;
             }
+
+            for (size_t p = 0; p <= seq[a].size(); p++) {
+                int fromA = gapFrom(a, p), toA = gapTo(a, p);
+                int lostA = Scheduler::strandedNights(fromA, toA);
+                if (lostA == 0) continue;
+
+                int bestGain = 0, bestSettled = 0;
+                size_t bestB = rooms, bestQ = 0;
+                for (size_t b = 0; b < rooms; b++) {
+                    if (b == a) continue;
+
+                    // Gaps of b that end after fromA and start before toA
+                    size_t q = lower_bound(seq[b].begin(), seq[b].end(), fromA,
+                        [&](int k, int day) { return stays[k].checkIn < day; }) - seq[b].begin();
+                    for (; q <= seq[b].size() && gapFrom(b, q) <= toA; q++) {
+                        int fromB = gapFrom(b, q), toB = gapTo(b, q);
+                        int gain = lostA + Scheduler::strandedNights(fromB, toB)
+                            - Scheduler::strandedNights(fromA, toB) - Scheduler::strandedNights(fromB, toA);
+                        if (gain <= 0 || gain < bestGain) continue;
+
+                        int n = settled(a, p, b) + settled(b, q, a);
+                        if (gain > bestGain || n > bestSettled) {
+                            bestGain = gain;
+                            bestSettled = n;
+                            bestB = b;
+                            bestQ = q;
+                        }
+                    }
+                }
+                if (bestB == rooms) continue;
+
+                vector<int> tailA(seq[a].begin() + p, seq[a].end());
+                seq[a].resize(p);
+                seq[a].insert(seq[a].end(), seq[bestB].begin() + bestQ, seq[bestB].end());
+                seq[bestB].resize(bestQ);
+                seq[bestB].insert(seq[bestB].end(), tailA.begin(), tailA.end());
+                swaps++;
+                improved = true;
+            }
+        }
+    }
+
+    for (size_t r = 0; r < rooms; r++)
+        for (int k : seq[r]) room[k] = static_cast<int>(r);
+    return budgetUsedUp;
+}
+
+vector<int> Scheduler::planCompact(const vector<Reservation>& reservations, const vector<Room>& rooms,
+    int pinBefore, chrono::milliseconds budget, CompactReport& report) {
+
+    auto deadline = chrono::steady_clock::now() + budget;
+    report = CompactReport();
+    Grouping g = group(reservations, rooms, pinBefore);
+
+    for (auto& plan : g.types) {
+        vector<Stay> stays;
+        vector<int> current;
+        stays.reserve(plan.movable.size());
+        current.reserve(plan.movable.size());
+        for (int i : plan.movable) {
+            stays.push_back({ reservations[i].getCheckInDay(), reservations[i].getCheckOutDay() });
+            current.push_back(g.currentRoom[i]);
         }
 
-        if (!placed) {
-            // Should never happen unless overbooked
-            res.setRoomNumber(-1);
+        vector<int> baseline = firstFit(stays, plan.releaseDays);
+        long long baselineStranded = strandedTotal(stays, baseline, plan.releaseDays);
+        report.firstFit += baselineStranded;
+        long long currentStranded = strandedTotal(stays, current, plan.releaseDays);
+        report.current += currentStranded;
+
+        // Search from the better start, so the result is never worse than first-fit
+        vector<int> room = bestFit(stays, plan.releaseDays, current);
+        long long bestFitStranded = strandedTotal(stays, room, plan.releaseDays);
+        if (unplacedCount(baseline) < unplacedCount(room) ||
+            (unplacedCount(baseline) == unplacedCount(room) && baselineStranded < bestFitStranded)) {
+            room = baseline;
         }
+
+        if (!report.budgetUsedUp)
+            report.budgetUsedUp = swapTails(stays, plan.releaseDays, current, room, deadline, report.swaps);
+
+        // Moving stays is only worth it when fewer nights are stranded
+        long long compactStranded = strandedTotal(stays, room, plan.releaseDays);
+        if (fits(stays, current, plan.releaseDays) &&
+            (unplacedCount(current) < unplacedCount(room) ||
+             (unplacedCount(current) == unplacedCount(room) && currentStranded <= compactStranded))) {
+            room = current;
+            compactStranded = currentStranded;
+        }
+        report.compact += compactStranded;
+
+        for (size_t k = 0; k < plan.movable.size(); k++)
+            g.assignedRoom[plan.movable[k]] = room[k];
     }
-}
\ No newline at end of file
+
+    return roomNumbers(g, rooms);
+}
@@ -0,0 +1,139 @@
+#include "StorageBackend.h"
+#include "SaxLoader.h"
+#include "JsonWriter.h"
+
+#include <fstream>
+
+using namespace std;
+
+namespace {
+
+// ================================================================
+//                  BINARY (BinaryStore)
+// ================================================================
+class BinaryBackend : public StorageBackend {
+public:
+    string name() const override { return "binary"; }
+    string extension() const override { return ".bin"; }
+
+    string encodeCustomers(const vector<Customer>& c) const override { return BinaryStore::encodeCustomers(c); }
+    string encodeReservations(const vector<Reservation>& r) const override { return BinaryStore::encodeReservations(r); }
+    string encodeRooms(const vector<Room>& r) const override { return BinaryStore::encodeRooms(r); }
+
+    bool decodeCustomers(const string& b, vector<Customer>& out) const override { return BinaryStore::decodeCustomers(b, out); }
+    bool decodeReservations(const string& b, vector<Reservation>& out) const override { return BinaryStore::decodeReservations(b, out); }
+    bool decodeRooms(const string& b, vector<Room>& out) const override { return BinaryStore::decodeRooms(b, out); }
+
+    bool isComplete(const string& path, BinaryStore::Kind kind) const override {
+        return BinaryStore::isComplete(path, kind);
+    }
+};
+
+// ================================================================
+//                  JSON TEXT
+// ================================================================
+// Records are written straight into one buffer (same bytes as
+// json::dump(4), without building a json DOM)
+template <class T>
+string writeArray(const vector<T>& items) {
+    JsonWriter w(4);
+    w.beginArray();
+    for (auto& item : items)
+        item.write_json(w);
+    w.endArray();
+    return w.str();
+}
+
+class JsonBackend : public StorageBackend {
+public:
+    string name() const override { return "json"; }
+    string extension() const override { return ".json"; }
+
+    string encodeCustomers(const vector<Customer>& c) const override { return writeArray(c); }
+    string encodeReservations(const vector<Reservation>& r) const override { return writeArray(r); }
+    string encodeRooms(const vector<Room>& r) const override { return writeArray(r); }
+
+    bool decodeCustomers(const string& b, vector<Customer>& out) const override {
+        return loadCustomersSax(b, input_format::json, out);
+    }
+    bool decodeReservations(const string& b, vector<Reservation>& out) const override {
+        return loadReservationsSax(b, input_format::json, out);
+    }
+    bool decodeRooms(const string& b, vector<Room>& out) const override {
+        return loadRoomsSax(b, input_format::json, out);
+    }
+
+    bool isComplete(const string& path, BinaryStore::Kind) const override {
+        return isCompleteJSONArray(path);
+    }
+};
+
+// ================================================================
+//                  CBOR / MESSAGEPACK (json.hpp codecs)
+// ================================================================
+// Encoded from the records' json form; decoded with the same SAX
+// handler as the JSON text, so no DOM is built when loading.
+class BinaryJsonBackend : public StorageBackend {
+private:
+    string backendName;
+    string ext;
+    input_format format;
+
+    template <class T>
+    string encode(const vector<T>& items) const {
+        json array = json::array();
+        for (auto& item : items)
+            array.push_back(item.to_json());
+
+        string out;
+        if (format == input_format::cbor) json::to_cbor(array, out);
+        else json::to_msgpack(array, out);
+        return out;
+    }
+
+public:
+    BinaryJsonBackend(const string& name, const string& extension, input_format format)
+        : backendName(name), ext(extension), format(format) {
+    }
+
+    string name() const override { return backendName; }
+    string extension() const override { return ext; }
+
+    string encodeCustomers(const vector<Customer>& c) const override { return encode(c); }
+    string encodeReservations(const vector<Reservation>& r) const override { return encode(r); }
+    string encodeRooms(const vector<Room>& r) const override { return encode(r); }
+
+    bool decodeCustomers(const string& b, vector<Customer>& out) const override {
+        return loadCustomersSax(b, format, out);
+    }
+    bool decodeReservations(const string& b, vector<Reservation>& out) const override {
+        return loadReservationsSax(b, format, out);
+    }
+    bool decodeRooms(const string& b, vector<Room>& out) const override {
+        return loadRoomsSax(b, format, out);
+    }
+
+    // Both formats store the element counts up front and the strict
+    // parser rejects a truncated file, so only an empty file is caught here
+    bool isComplete(const string& path, BinaryStore::Kind) const override {
+        ifstream f(path, ios::binary | ios::ate);
+        return f.good() && f.tellg() > 0;
+    }
+};
+
+} // namespace
+
+// ================================================================
+//                  FACTORY
+// ================================================================
+shared_ptr<const StorageBackend> StorageBackend::create(const string& name) {
+    if (name == "binary") return make_shared<BinaryBackend>();
+    if (name == "json") return make_shared<JsonBackend>();
+    if (name == "cbor") return make_shared<BinaryJsonBackend>("cbor", ".cbor", input_format::cbor);
+    if (name == "msgpack") return make_shared<BinaryJsonBackend>("msgpack", ".msgpack", input_format::msgpack);
+    return nullptr;
+}
+
+vector<string> StorageBackend::names() {
+    return { "binary", "json", "cbor", "msgpack" };
+}
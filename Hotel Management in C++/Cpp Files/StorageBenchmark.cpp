@@ -0,0 +1,137 @@
+#include "StorageBenchmark.h"
+#include "StorageBackend.h"
+#include "AtomicFile.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+using namespace std;
+
+// ================================================================
+//                  SYNTHETIC DATA
+// ================================================================
+namespace {
+
+struct Dataset {
+    vector<Customer> customers;
+    vector<Reservation> reservations;
+    vector<Room> rooms;
+};
+
+string date(int year, int month, int day) {
+    char buf[16];
+    snprintf(buf, sizeof buf, "%04d-%02d-%02d", year, month, day);
+    return buf;
+}
+
+// Same layout as HotelSystem::initializeRooms
+Dataset makeDataset(size_t customerCount, size_t reservationCount) {
+    Dataset d;
+
+    for (int i = 101; i <= 112; i++) d.rooms.emplace_back(i, 1, "Single", 150);
+    for (int i = 201; i <= 208; i++) d.rooms.emplace_back(i, 2, "Double", 250);
+    for (int i = 301; i <= 306; i++) d.rooms.emplace_back(i, 3, "Suite", 400);
+    for (auto& r : d.rooms) r.addComment("Checked by housekeeping");
+
+    for (size_t i = 0; i < customerCount; i++) {
+        int id = static_cast<int>(i) + 1;
+        d.customers.emplace_back(id, "Customer " + to_string(id), "70 123 456",
+            "customer" + to_string(id) + "@gmail.com", id % 7);
+    }
+
+    for (size_t i = 0; i < reservationCount; i++) {
+        int id = static_cast<int>(i) + 1;
+        Room& room = d.rooms[i % d.rooms.size()];
+        int nights = 1 + static_cast<int>(i % 5);
+        int day = 1 + static_cast<int>((i / d.rooms.size()) % 23);
+        int month = 1 + static_cast<int>((i / 7) % 12);
+        int year = 2020 + static_cast<int>(i % 10);
+
+        d.reservations.emplace_back(id, 1 + static_cast<int>(i % max<size_t>(customerCount, 1)),
+            date(year, month, day), date(year, month, day + nights),
+            room.getRoomNumber(), room.getFloor(), room.getType(),
+            nights, nights * room.getPrice() * (i % 3 == 0 ? 0.9 : 1.0));
+        room.addReservation(id);
+    }
+
+    return d;
+}
+
+double millisSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// ================================================================
+//                  RUN
+// ================================================================
+void StorageBenchmark::run(size_t customerCount, size_t reservationCount, int rounds) {
+    Dataset data = makeDataset(customerCount, reservationCount);
+
+    stringstream out;
+    out << "\n===== STORAGE BENCHMARK =====\n"
+        << data.customers.size() << " customers, " << data.reservations.size()
+        << " reservations, " << data.rooms.size() << " rooms (best of " << rounds << ")\n\n"
+        << left << setw(10) << "Backend"
+        << right << setw(12) << "Save (ms)" << setw(12) << "Load (ms)" << setw(12) << "Size (KB)" << "\n";
+    cout << out.str();
+
+    for (auto& name : StorageBackend::names()) {
+        auto backend = StorageBackend::create(name);
+        string files[3] = {
+            "bench_customers" + backend->extension(),
+            "bench_reservations" + backend->extension(),
+            "bench_rooms" + backend->extension()
+        };
+
+        double bestSave = 0, bestLoad = 0;
+        size_t size = 0;
+        bool ok = true;
+
+        for (int round = 0; round < max(rounds, 1); round++) {
+            auto start = chrono::steady_clock::now();
+            string bytes[3] = {
+                backend->encodeCustomers(data.customers),
+                backend->encodeReservations(data.reservations),
+                backend->encodeRooms(data.rooms)
+            };
+            for (int f = 0; f < 3; f++)
+                ok = AtomicFile::write(files[f], bytes[f]) && ok;
+            double save = millisSince(start);
+
+            start = chrono::steady_clock::now();
+            vector<Customer> customers;
+            vector<Reservation> reservations;
+            vector<Room> rooms;
+            string read[3];
+            for (int f = 0; f < 3; f++)
+                ok = BinaryStore::readFile(files[f], read[f]) && ok;
+            ok = backend->decodeCustomers(read[0], customers) && ok;
+            ok = backend->decodeReservations(read[1], reservations) && ok;
+            ok = backend->decodeRooms(read[2], rooms) && ok;
+            double load = millisSince(start);
+
+            ok = ok && customers.size() == data.customers.size() &&
+                reservations.size() == data.reservations.size() && rooms.size() == data.rooms.size();
+
+            bestSave = round == 0 ? save : min(bestSave, save);
+            bestLoad = round == 0 ? load : min(bestLoad, load);
+            size = bytes[0].size() + bytes[1].size() + bytes[2].size();
+        }
+
+        for (auto& f : files) remove(f.c_str());
+
+        stringstream row;
+        row << fixed << setprecision(1)
+            << left << setw(10) << name
+            << right << setw(12) << bestSave << setw(12) << bestLoad << setw(12) << size / 1024.0;
+        if (!ok) row << "  (round trip failed)";
+        row << "\n";
+        cout << row.str();
+    }
+}
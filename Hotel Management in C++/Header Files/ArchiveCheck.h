@@ -0,0 +1,17 @@
+#ifndef ARCHIVECHECK_H
+#define ARCHIVECHECK_H
+
+#include <string>
+
+using namespace std;
+
+// Crash check of the reservation archive on a scratch file: appends two
+// blocks, tears the last one as a crash mid-append would, appends again
+// and verifies that every intact stay is read back and that the highest
+// ID covers the new block. Run with --check-archive.
+class ArchiveCheck {
+public:
+    static bool run(const string& path = "archive-check.tmp");
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <string>
+
+using namespace std;
+
+// Crash-safe file replacement: the new contents are written to
+// "<path>.tmp", flushed to disk, and renamed over the old file, so a
+// reader only ever sees the complete old file or the complete new one.
+//
+// For a batch of files call writeTemp() for each, then commit() for each,
+// then syncDirectory() once.
+class AtomicFile {
+public:
+    static string tempPath(const string& path) { return path + ".tmp"; }
+
+    // Write bytes to <path>.tmp and fsync them
+    static bool writeTemp(const string& path, const string& bytes);
+
+    // Atomically replace <path> with <path>.tmp
+    static bool commit(const string& path);
+
+    // Make the renames in the directory of <path> durable (no-op on Windows)
+    static void syncDirectory(const string& path);
+
+    // All three steps for a single file
+    static bool write(const string& path, const string& bytes);
+
+    // Append bytes to <path> and fsync them (append-only files)
+    static bool append(const string& path, const string& bytes);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef AVAILABILITYMAP_H
+#define AVAILABILITYMAP_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "Room.h"
+
+using namespace std;
+
+// Per room type, one bit row per day over a rolling horizon: bit i of
+// a row is set when the i-th room of the type is booked that night.
+//
+// "Which room of this type is free for [checkIn, checkOut)?" ORs the
+// rows of the stay word by word (two words at a time with SSE2) and
+// takes the first clear bit, without touching a reservation. Booking
+// uses it as a quick "is any room of the type free?" test before the
+// best-fit scan over the per-room intervals. Days are day numbers
+// (Calendar); stays that leave the horizon are not covered and the
+// caller falls back to the per-room intervals.
+class AvailabilityMap {
+public:
+    static const int DefaultHorizonDays = 400;
+
+private:
+    struct TypeTable {
+        string type;
+        vector<int> roomSlots;      // bit -> slot in rooms
+        size_t words = 0;           // 64-bit words per day row
+        vector<uint64_t> rows;      // day-major: rows[day * words + w]
+    };
+
+    struct SlotBit {
+        int table = -1;
+        int bit = 0;
+    };
+
+    int firstDay = 0;
+    int horizonDays = 0;
+    vector<TypeTable> tables;
+    vector<SlotBit> slotBits;       // slot in rooms -> table and bit
+
+    const TypeTable* findTable(const string& type) const;
+    void setRange(int slot, int checkIn, int checkOut, bool booked);
+
+public:
+    // Empty rows for the rooms, days [firstDay, firstDay + horizonDays)
+    void reset(const vector<Room>& rooms, int firstDay, int horizonDays = DefaultHorizonDays);
+
+    int getFirstDay() const { return firstDay; }
+    bool covers(int checkIn, int checkOut) const {
+        return checkIn >= firstDay && checkOut <= firstDay + horizonDays && checkIn < checkOut;
+    }
+
+    // Nights outside the horizon are ignored
+    void book(int slot, int checkIn, int checkOut) { setRange(slot, checkIn, checkOut, true); }
+    void release(int slot, int checkIn, int checkOut) { setRange(slot, checkIn, checkOut, false); }
+
+    // Slot of the first room of the type free for the whole stay, -1 if
+    // none (the stay must be covered)
+    int findFree(const string& type, int checkIn, int checkOut) const;
+
+    // Whether the room is booked on the night of the day (inside the horizon)
+    bool isBooked(int slot, int day) const;
+};
+
+#endif
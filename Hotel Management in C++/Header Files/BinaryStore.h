@@ -0,0 +1,76 @@
+#ifndef BINARYSTORE_H
+#define BINARYSTORE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Customer.h"
+#include "Reservation.h"
+#include "Room.h"
+
+using namespace std;
+
+// Versioned binary snapshot format (little-endian):
+//
+//   header  : magic "HTLB" | u32 version | u32 kind | u32 count | u64 payloadSize
+//   payload : <count> records
+//   trailer : u64 FNV-1a checksum of the payload
+//
+// Reservations are fixed-width records (ReservationRecordSize bytes,
+// room type in RoomTypeWidth bytes); customers and rooms use
+// length-prefixed strings. Version 2 stores
+// reservation dates as day numbers; version 1 files (dates as text,
+// 56-byte records) are still read.
+class BinaryStore {
+public:
+    static const uint32_t Version = 2;
+    static const uint32_t MinVersion = 1;
+    static const size_t HeaderSize = 24;
+    static const size_t TrailerSize = 8;
+    static const size_t ReservationRecordSize = 44;
+    static const size_t RoomTypeWidth = 8;
+
+    enum Kind : uint32_t { Customers = 1, Reservations = 2, Rooms = 3 };
+
+    static string encodeCustomers(const vector<Customer>& customers);
+    // Empty when a room type is longer than RoomTypeWidth (it would be
+    // cut and read back as another type); the snapshot is not written then
+    static string encodeReservations(const vector<Reservation>& reservations);
+    static string encodeRooms(const vector<Room>& rooms);
+
+    // Decoders return false on a bad magic, version, kind, size or checksum,
+    // or a record count that does not match the payload
+    static bool decodeCustomers(const string& bytes, vector<Customer>& out);
+    static bool decodeReservations(const string& bytes, vector<Reservation>& out);
+    static bool decodeReservations(const char* data, size_t size, vector<Reservation>& out);
+    static bool decodeRooms(const string& bytes, vector<Room>& out);
+
+    // Cheap envelope check (magic, version, kind, total size) without
+    // touching the payload or verifying the checksum
+    static bool checkHeader(const char* data, size_t size, uint32_t kind, uint32_t& count);
+    static bool checkHeader(const char* data, size_t size, uint32_t kind, uint32_t& count, uint32_t& version);
+
+    // Field offsets of one fixed-width reservation record (id at 0,
+    // customerId at 4 in every version)
+    struct RecordLayout {
+        size_t size;
+        size_t checkIn, checkOut, roomNumber, floor, roomType, nights, finalPrice;
+        bool textDates;   // version 1: "YYYY-MM-DD" in 10 bytes
+    };
+    static const RecordLayout& reservationLayout(uint32_t version);
+    static Reservation decodeReservationRecord(const char* record, const RecordLayout& layout);
+
+    // Startup check: reads only the header and compares it with the file
+    // size, so a torn snapshot is rejected before it is read or decoded
+    static bool isComplete(const string& path, uint32_t kind);
+
+    static bool readFile(const string& path, string& bytes);
+
+    // Crash-safe write (temp file + fsync + rename)
+    static bool writeFile(const string& path, const string& bytes);
+
+    static uint64_t checksum(const char* data, size_t size);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef BOOKINGINTERVALS_H
+#define BOOKINGINTERVALS_H
+
+#include <map>
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+// Booked [checkIn, checkOut) ranges of one room (day numbers), ordered
+// by check-in.
+//
+// Bookings of a room never overlap, so they are also ordered by
+// check-out: a range is free when the last booking that starts before
+// it ends has already ended. That is one map lookup, O(log n).
+// Overlapping bookings (hand-edited or legacy data) are still tracked,
+// in a side list that is normally empty, so they keep blocking the room.
+class BookingIntervals {
+private:
+    struct Booking {
+        int checkIn;
+        int checkOut;
+        int reservationId;
+    };
+
+    map<int, Booking> bookings;        // keyed by check-in, non-overlapping
+    vector<Booking> conflicts;         // overlapping bookings
+
+public:
+    void add(int checkIn, int checkOut, int reservationId);
+    void remove(int checkIn, int reservationId);
+    void clear();
+
+    bool isFree(int checkIn, int checkOut) const;
+
+    // For a free range: latest check-out at or before checkIn (INT_MIN if
+    // none) and earliest check-in at or after checkOut (INT_MAX if none),
+    // overlapping bookings included
+    void neighbors(int checkIn, int checkOut, int& prevCheckOut, int& nextCheckIn) const {
+        auto it = bookings.lower_bound(checkIn);
+        nextCheckIn = it == bookings.end() ? INT_MAX : it->first;
+        prevCheckOut = it == bookings.begin() ? INT_MIN : prev(it)->second.checkOut;
+
+        for (auto& b : conflicts) {
+            if (b.checkOut <= checkIn) prevCheckOut = max(prevCheckOut, b.checkOut);
+            else if (b.checkIn >= checkOut) nextCheckIn = min(nextCheckIn, b.checkIn);
+        }
+    }
+
+    // Calls visit(checkIn, checkOut, reservationId) for every booking
+    // that overlaps [from, to): O(log n) plus the bookings visited
+    template <class Visit>
+    void forEachOverlap(int from, int to, Visit visit) const {
+        auto it = bookings.lower_bound(from);
+        if (it != bookings.begin() && from < prev(it)->second.checkOut) --it;
+        for (; it != bookings.end() && it->first < to; ++it)
+            visit(it->second.checkIn, it->second.checkOut, it->second.reservationId);
+
+        for (auto& b : conflicts)
+            if (from < b.checkOut && b.checkIn < to) visit(b.checkIn, b.checkOut, b.reservationId);
+    }
+    size_t size() const { return bookings.size() + conflicts.size(); }
+    bool hasConflicts() const { return !conflicts.empty(); }
+};
+
+#endif
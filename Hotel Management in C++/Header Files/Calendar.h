@@ -0,0 +1,99 @@
+#ifndef CALENDAR_H
+#define CALENDAR_H
+
+#include <string>
+#include <string_view>
+#include <climits>
+
+using namespace std;
+
+// Day numbers: days since 1970-01-01 in the proleptic Gregorian
+// calendar, so date ranges become integer ranges. Reservations keep
+// their dates as day numbers; text is only produced for the console
+// and the file formats.
+//
+// Everything except today() is constexpr and pure arithmetic: no
+// mktime/localtime, no timezone lock. The static_asserts in
+// Calendar.cpp check the algorithms at compile time.
+class Calendar {
+public:
+    // Day number of a date that did not parse
+    static const int NoDay = INT_MIN;
+
+    struct Civil {
+        int year;
+        unsigned month;   // 1-12
+        unsigned day;     // 1-31
+    };
+
+    static constexpr bool isLeapYear(int y) {
+        return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+    }
+
+    static constexpr unsigned daysInMonth(int y, unsigned m) {
+        return m == 2 ? (isLeapYear(y) ? 29u : 28u) : (m == 4 || m == 6 || m == 9 || m == 11) ? 30u : 31u;
+    }
+
+    static constexpr bool isValid(int y, unsigned m, unsigned d) {
+        return m >= 1 && m <= 12 && d >= 1 && d <= daysInMonth(y, m);
+    }
+
+    // Civil date -> day number (H. Hinnant's days_from_civil)
+    static constexpr int daysFromCivil(int y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        int era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int>(doe) - 719468;
+    }
+
+    // Day number -> civil date (civil_from_days)
+    static constexpr Civil civilFromDays(int z) {
+        z += 719468;
+        int era = (z >= 0 ? z : z - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int y = static_cast<int>(yoe) + era * 400;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        unsigned d = doy - (153 * mp + 2) / 5 + 1;
+        unsigned m = mp < 10 ? mp + 3 : mp - 9;
+        return Civil{ y + (m <= 2), m, d };
+    }
+
+    // 0 = Sunday ... 6 = Saturday
+    static constexpr unsigned weekday(int day) {
+        return static_cast<unsigned>(day >= -4 ? (day + 4) % 7 : (day + 5) % 7 + 6);
+    }
+
+    // "YYYY-MM-DD" -> day number, NoDay if the text is not a real date
+    static constexpr int parseDay(string_view s) {
+        if (s.size() != 10 || s[4] != '-' || s[7] != '-') return NoDay;
+        for (size_t i = 0; i < 10; i++)
+            if (i != 4 && i != 7 && (s[i] < '0' || s[i] > '9')) return NoDay;
+
+        int y = (s[0] - '0') * 1000 + (s[1] - '0') * 100 + (s[2] - '0') * 10 + (s[3] - '0');
+        unsigned m = static_cast<unsigned>((s[5] - '0') * 10 + (s[6] - '0'));
+        unsigned d = static_cast<unsigned>((s[8] - '0') * 10 + (s[9] - '0'));
+        if (!isValid(y, m, d)) return NoDay;
+
+        return daysFromCivil(y, m, d);
+    }
+
+    // Same, false if the text is not a real date
+    static bool toDay(const string& s, int& day) {
+        int parsed = parseDay(s);
+        if (parsed == NoDay) return false;
+        day = parsed;
+        return true;
+    }
+
+    // Day number -> "YYYY-MM-DD" ("" for NoDay)
+    static string fromDay(int day);
+
+    // Local date of the machine (the only call into the C time library)
+    static int today();
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef CALENDARBENCHMARK_H
+#define CALENDARBENCHMARK_H
+
+#include <cstddef>
+
+using namespace std;
+
+// Compares the Calendar functions with the mktime/localtime based date
+// helpers they replaced (kept here as the baseline): parsing and
+// validation, night counts, the "before today" check and formatting.
+// Run with --bench-calendar.
+class CalendarBenchmark {
+public:
+    static void run(size_t dateCount = 1000000, int rounds = 3);
+};
+
+#endif
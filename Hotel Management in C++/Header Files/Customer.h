@@ -3,6 +3,7 @@
 
 #include <string>
 #include "json.hpp"
+#include "JsonWriter.h"
 
 using namespace std;
 using json = nlohmann::json;
@@ -46,6 +47,18 @@ public:
         };
     }
 
+    // Streams the to_json keys straight to the writer, alphabetically,
+    // so the text matches a dump of to_json
+    void write_json(JsonWriter& w) const {
+        w.beginObject();
+        w.field("email", email);
+        w.field("id", id);
+        w.field("name", name);
+        w.field("phone", phone);
+        w.field("totalBookings", totalBookings);
+        w.endObject();
+    }
+
     static Customer from_json(const json& j) {
         return Customer(
             j.at("id").get<int>(),
@@ -5,10 +5,24 @@
 #include <string>
 #include <optional>
 #include <unordered_map>
+#include <set>
+#include <map>
+#include <memory>
 
 #include "Customer.h"
 #include "Reservation.h"
 #include "Room.h"
+#include "Journal.h"
+#include "MappedReservations.h"
+#include "ReservationShards.h"
+#include "ReservationArchive.h"
+#include "StorageBackend.h"
+#include "SlotMap.h"
+#include "RoomIndex.h"
+#include "BookingIntervals.h"
+#include "AvailabilityMap.h"
+#include "PersistenceWorker.h"
+#include "Scheduler.h"
 
 using namespace std;
 
@@ -16,8 +30,38 @@ class HotelSystem {
 
 private:
     vector<Customer> customers;
-    vector<Reservation> reservations;
+    unordered_map<int, size_t> customerIndex;   // customer ID -> slot in customers
+    // Loaded lazily: while reservationsMaterialized is false the store is
+    // only the shard manifest; listings map the month shards they need.
+    // Reservations are found by ID through reservationIndex; deletes are
+    // swap-and-pop, so the dense order is not the insertion order.
+    mutable SlotMap<Reservation> reservations;
+    mutable unordered_map<int, SlotMap<Reservation>::Handle> reservationIndex;
+    // customer ID -> IDs of their working-set reservations (archived stays
+    // are found through the archive's block customer ranges)
+    mutable unordered_map<int, vector<int>> customerReservations;
+    vector<ReservationShard> reservationShards;   // months on disk
+    mutable bool reservationsMaterialized = true;
+    // Corrupted shards found when materializing: restored from the JSON
+    // file (rewritten at the next checkpoint), or kept as they are on disk
+    // and never overwritten while their month has unsaved changes
+    mutable set<string> restoredMonths;
+    mutable map<string, ReservationShard> unreadableShards;
     vector<Room> rooms;
+    RoomIndex roomIndex;      // room number -> slot in rooms, rebuilt by initializeRooms
+    // Booked ranges of the working-set reservations, per room slot; kept
+    // in step with the slot map by the reservation helpers below
+    mutable vector<BookingIntervals> roomBookings;
+    // The same bookings as per-type day bitmaps from today on (rebuilt
+    // when the date changes)
+    mutable AvailabilityMap availability;
+
+    // Incremental scheduling: day ranges per room type touched by bookings
+    // and cancellations since the scheduler last ran. They are not saved,
+    // so after a restart (or an import) the first run re-plans everything.
+    map<string, vector<pair<int, int>>> scheduleWindows;
+    bool scheduleWindowsKnown = false;
+    const int compactBudgetMs = 500;   // search time of the compact room plan
 
     int nextCustomerId = 1;
     int nextReservationId = 1;
@@ -25,12 +69,53 @@ private:
     const string customersFile = "customers.json";
     const string reservationsFile = "reservations.json";
     const string roomsFile = "rooms.json";
+    const string journalFile = "journal.log";
+
+    // Snapshot format of the checkpoints (StorageBackend, --storage=NAME).
+    // The JSON files are kept for export/import and migrated automatically.
+    shared_ptr<const StorageBackend> storage;
+    shared_ptr<const StorageBackend> jsonFormat = StorageBackend::create("json");
+    string customersSnapshot;      // customers<ext>
+    string reservationsSnapshot;   // reservations<ext>, unless sharded
+    string roomsSnapshot;          // rooms<ext>
+
+    // The binary backend shards reservations by check-in month
+    const string reservationsBinFile = "reservations.bin";   // pre-shard snapshot, migrated
+    const string reservationsDir = "reservations";          // one shard per check-in month
+
+    // Cold tier: stays that checked out more than archiveHorizonDays ago
+    // leave the working set and are appended to the archive (-1 = never)
+    const string archiveFile = "reservations.archive";
+    int archiveHorizonDays;
+    ReservationArchive archive{ archiveFile };
+    vector<Reservation> archivePending;   // appended at the next checkpoint
+    bool archiveReset = false;            // the next checkpoint rewrites the archive instead
+
+    // Journal mode: each mutation appends one record to the log instead of
+    // rewriting every snapshot file; checkpoint() folds the log. Without it
+    // every mutation is a checkpoint (--no-journal).
+    bool journalMode;
+    const size_t checkpointInterval = 100;   // records between checkpoints
+    size_t journalRecords = 0;               // records since the last checkpoint
+    Journal journal{ journalFile };
+
+    // All file writes happen on this background thread
+    PersistenceWorker persistence{ journal };
+
+    // Dirty flags: a checkpoint only rewrites the files whose collection
+    // changed since the previous checkpoint. Reservations are tracked per
+    // check-in month; reservationsDirty forces every shard to be rewritten.
+    bool customersDirty = false;
+    bool reservationsDirty = false;
+    set<string> dirtyReservationMonths;
+    bool roomsDirty = false;
 
 public:
-    HotelSystem();
+    explicit HotelSystem(const string& storageName = "binary", int archiveHorizonDays = 30,
+                         bool journalMode = true);
     void loadData();
-    void saveData() const;
-    string getToday() const;
+    void saveData();
+    int getToday() const;
 
     // ==========================================================
     // MENUS
@@ -76,38 +161,126 @@ public:
     void adminAddRoomComment();
     void adminViewAllComments();
     void adminCancelReservation();
+    void exportJSON();
+    void importJSON();
+    void adminPreviewSchedule() const;
+    void adminCompactSchedule();
 
     // ==========================================================
     // SCHEDULER
     // ==========================================================
-    void runScheduler();
-    
+    void runScheduler();        // re-plans the changed date windows only
+    void runFullScheduler();    // re-plans every stay that has not started
 
 private:
 
+    void indexCustomers();
+    void insertCustomer(const Customer& c);
+    void eraseCustomer(int id);
+
     Customer* getCustomerRef(int id);
     optional<Customer> getCustomerOptional(int id) const;
-    Reservation* getReservationRef(int id);
-    const Reservation* getReservationConst(int id) const;
+    void setReservations(vector<Reservation> list) const;
+    void insertReservation(const Reservation& r);
+    void eraseReservation(int id);
+    void linkCustomer(const Reservation& r) const;
+    void unlinkCustomer(const Reservation& r) const;
+    void linkBooking(const Reservation& r) const;
+    void unlinkBooking(const Reservation& r) const;
+    void rebuildRoomBookings() const;
+    void refreshAvailability() const;
+
+    // ==========================================================
+    // INCREMENTAL SCHEDULING
+    // ==========================================================
+    // The planners are dry runs: they return the room moves, and
+    // applyRoomMoves makes them
+    struct ReplanResult {
+        bool planned = false;    // false: the stays do not fit, no moves
+        int from = 0, to = 0;    // span of the re-planned stays
+        size_t stays = 0;
+        vector<Scheduler::RoomMove> moves;
+        int newStaySlot = -1;    // room slot for the stay being booked
+    };
+    struct SchedulePlan {
+        size_t components = 0;
+        size_t stays = 0;
+        size_t overbooked = 0;   // components left as they are
+        vector<Scheduler::RoomMove> moves;
+    };
+    void markScheduleWindow(const string& type, int from, int to);
+    ReplanResult planComponent(const string& type, int from, int to, bool withNewStay) const;
+    SchedulePlan planScheduleWindows() const;
+    void applyRoomMoves(const vector<Scheduler::RoomMove>& moves);
+    void printRoomMoves(const vector<Scheduler::RoomMove>& moves) const;
+
+    // Handle of a reservation (a stale one if the ID is unknown). Resolve
+    // it with reservations.get() where it is used: an insert or erase moves
+    // the dense values, and a stale handle then resolves to nullptr
+    // instead of to another reservation.
+    SlotMap<Reservation>::Handle findReservation(int id) const;
     Room* getRoomRef(int roomNumber);
     const Room* getRoomConst(int roomNumber) const;
 
-    int calculateNights(const string& in, const string& out) const;
+    int calculateNights(int in, int out) const;
     bool validDate(const string& d) const;
     double getBasePriceForRoomType(const string& type) const;
 
     void sortReservations();
-    void autoSave() const;
+    void ensureReservationsLoaded() const;
+    void updateNextIds();
+    void autoSave(const string& record);
+    bool checkpoint();
+    void markReservationDirty(const Reservation& r);
+    void queueReservationShards(vector<PersistenceWorker::SnapshotFile>& files);
+
+    template <class Keep, class Visit>
+    void forEachShardRecord(Keep keepMonth, Visit visit) const;
+
+    int archiveCutoff() const;
+    void archiveCompletedReservations();
+
+    // ==========================================================
+    // JOURNAL REPLAY
+    // ==========================================================
+    void replayJournal();
+    void applyJournalRecord(const json& record);
+    void upsertCustomer(const Customer& c);
+    void upsertReservation(const Reservation& r);
+    void removeReservation(int id);
+
+    // ==========================================================
+    // STARTUP LOAD (one thread per file)
+    // ==========================================================
+    void loadCustomers();
+    void loadReservations();
+    void loadRooms();
 
     // ==========================================================
     // JSON
     // ==========================================================
-    void loadCustomersJSON();
-    void loadReservationsJSON();
-    void loadRoomsJSON();
+    // False if the file exists but is torn or invalid: the collection is
+    // then left empty (initial rooms) and must not be migrated over it
+    bool loadCustomersJSON();
+    bool loadReservationsJSON();
+    bool loadRoomsJSON();
     void saveCustomersJSON() const;
     void saveReservationsJSON() const;
     void saveRoomsJSON() const;
+    void mergeLoadedRooms(const vector<Room>& loaded);
+    // Room types longer than the binary field take the type of their room;
+    // reservations without such a room are removed. Returns how many.
+    size_t fitRoomTypes(vector<Reservation>& list) const;
+
+    // ==========================================================
+    // SNAPSHOTS (storage backend)
+    // ==========================================================
+    bool binarySnapshots() const { return storage->name() == "binary"; }
+    bool jsonSnapshots() const { return storage->name() == "json"; }
+    bool loadCustomersSnapshot();
+    bool loadReservationsSnapshot();
+    bool loadReservationsBinary();
+    bool loadRoomsSnapshot();
 
     // ==========================================================
     // REQUIRED FIX  UNIVERSAL "00" EXIT HELPER
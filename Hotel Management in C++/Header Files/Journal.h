@@ -0,0 +1,31 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+// Append-only write-ahead log. Every mutation is written as one compact
+// JSON record per line; a checkpoint folds the log into the snapshot
+// files and truncates it. Writes are issued by the PersistenceWorker.
+class Journal {
+private:
+    string path;
+
+public:
+    explicit Journal(const string& path) : path(path) {}
+
+    // Append one or more newline-terminated records with a single write
+    void appendBatch(const string& lines);
+
+    // Read every complete record (a torn last line is ignored)
+    vector<json> readAll() const;
+
+    // Drop all records (called after a successful checkpoint)
+    void truncate();
+};
+
+#endif
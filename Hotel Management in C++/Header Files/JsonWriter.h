@@ -0,0 +1,57 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Streaming JSON writer that formats values straight into one reusable
+// buffer, without building a json DOM. Output is byte-identical to
+// json::dump() (compact) or json::dump(indent) (pretty) as long as object
+// keys are written in sorted order, which is how nlohmann::json stores them.
+class JsonWriter {
+private:
+    struct Level {
+        bool isArray;
+        size_t count;
+    };
+
+    string out;
+    int indent;            // -1 = compact
+    vector<Level> stack;
+    bool afterKey = false;
+
+    void beforeValue();
+    void newline(size_t depth);
+    void escape(const string& s);
+
+public:
+    explicit JsonWriter(int indent = -1) : indent(indent) {}
+
+    // Reuse the buffer (keeps its capacity)
+    void clear();
+    const string& str() const { return out; }
+
+    void beginArray();
+    void endArray();
+    void beginObject();
+    void endObject();
+
+    void key(const char* k);
+
+    void value(int v);
+    void value(long long v);
+    void value(double v);
+    void value(const string& v);
+    void value(const char* v);
+
+    // key + value in one call
+    template <typename T>
+    void field(const char* k, const T& v) {
+        key(k);
+        value(v);
+    }
+};
+
+#endif
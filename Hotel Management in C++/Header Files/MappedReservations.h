@@ -0,0 +1,84 @@
+#ifndef MAPPEDRESERVATIONS_H
+#define MAPPEDRESERVATIONS_H
+
+#include <string>
+#include <cstdint>
+
+#include "BinaryStore.h"
+#include "Reservation.h"
+#include "Calendar.h"
+
+using namespace std;
+
+// Read-only view over one fixed-width record of a mapped reservation snapshot.
+// Getters decode straight from the mapped bytes; nothing is copied until
+// materialize() is called.
+class ReservationView {
+private:
+    const char* p;
+    const BinaryStore::RecordLayout* layout;
+
+    int field(size_t offset) const;
+    string text(size_t offset, size_t width) const;
+    int day(size_t offset) const {
+        return layout->textDates ? Calendar::parseDay(text(offset, 10)) : field(offset);
+    }
+
+public:
+    ReservationView(const char* record, const BinaryStore::RecordLayout& layout)
+        : p(record), layout(&layout) {}
+
+    int getId() const { return field(0); }
+    int getCustomerId() const { return field(4); }
+    int getCheckInDay() const { return day(layout->checkIn); }
+    int getCheckOutDay() const { return day(layout->checkOut); }
+    string getCheckIn() const { return Calendar::fromDay(getCheckInDay()); }
+    string getCheckOut() const { return Calendar::fromDay(getCheckOutDay()); }
+    int getRoomNumber() const { return field(layout->roomNumber); }
+    int getFloor() const { return field(layout->floor); }
+    string getRoomType() const { return text(layout->roomType, BinaryStore::RoomTypeWidth); }
+    int getNights() const { return field(layout->nights); }
+    double getFinalPrice() const;
+
+    Reservation materialize() const { return BinaryStore::decodeReservationRecord(p, *layout); }
+};
+
+// Memory-mapped reservation snapshot (a month shard, or the pre-shard
+// reservations.bin). open() only checks the header and the file size; the
+// checksum is verified when the snapshot is materialized.
+class MappedReservations {
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+    size_t count = 0;
+    const BinaryStore::RecordLayout* layout = &BinaryStore::reservationLayout(BinaryStore::Version);
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+public:
+    MappedReservations() = default;
+    MappedReservations(const MappedReservations&) = delete;
+    MappedReservations& operator=(const MappedReservations&) = delete;
+    ~MappedReservations() { close(); }
+
+    // Returns false if the file is missing or not a reservation snapshot
+    bool open(const string& path);
+    void close();
+
+    bool isOpen() const { return base != nullptr; }
+    size_t size() const { return count; }
+
+    ReservationView operator[](size_t i) const {
+        return ReservationView(base + BinaryStore::HeaderSize + i * layout->size, *layout);
+    }
+
+    // Decode every record into Reservation objects (verifies the checksum)
+    bool materialize(vector<Reservation>& out) const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef PERSISTENCEWORKER_H
+#define PERSISTENCEWORKER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Journal.h"
+
+using namespace std;
+
+// Background thread that performs all persistence I/O for HotelSystem.
+//
+// The interactive thread only queues work: journal records, and checkpoints
+// made of snapshot files whose encoders captured immutable copies of the
+// collections. The worker drains the queue in batches (group commit): all
+// records of a batch are appended with one write, and when a batch holds
+// several checkpoints only the newest copy of each file is written
+// (appended files, such as archive blocks, are all written in order).
+class PersistenceWorker {
+public:
+    struct SnapshotFile {
+        string path;
+        function<string()> encode;   // runs on the worker thread
+        bool append = false;         // appended to the file instead of replacing it
+        function<bool(const string&)> appendWith = nullptr;   // custom append (default AtomicFile::append)
+    };
+
+private:
+    struct Job {
+        bool isCheckpoint = false;
+        string record;                  // journal line (without newline)
+        vector<SnapshotFile> files;     // checkpoint contents
+    };
+
+    Journal& journal;
+
+    mutex m;
+    condition_variable wake;
+    condition_variable idle;
+    deque<Job> queue;
+    bool busy = false;
+    bool stopping = false;
+    thread worker;
+
+    // Files of a checkpoint that failed, written again with the next one
+    // (worker thread only): the next checkpoint may only hold the
+    // collections that changed since, and it truncates the journal
+    map<string, function<string()>> unwritten;
+    vector<SnapshotFile> unwrittenAppends;
+
+    void run();
+    void writeBatch(deque<Job>& batch);
+
+public:
+    explicit PersistenceWorker(Journal& journal);
+    ~PersistenceWorker();
+
+    PersistenceWorker(const PersistenceWorker&) = delete;
+    PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+    void appendRecord(string record);
+
+    // Write the given snapshot files, then truncate the journal
+    void checkpoint(vector<SnapshotFile> files);
+
+    // Barrier: returns once everything queued so far is on disk
+    void flush();
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <string>
 #include "json.hpp"
+#include "JsonWriter.h"
+#include "Calendar.h"
 using namespace std;
 using json = nlohmann::json;
 
@@ -10,8 +12,8 @@ class Reservation {
 private:
     int id;
     int customerId;
-    string checkIn;
-    string checkOut;
+    int checkIn;                       // day numbers (Calendar), [checkIn, checkOut)
+    int checkOut;
     int roomNumber;
     int floor;
     string roomType;
@@ -20,11 +22,11 @@ private:
 
 public:
     Reservation()
-        : id(-1), customerId(-1), roomNumber(-1),
-        floor(0), nights(0), finalPrice(0.0) {
+        : id(-1), customerId(-1), checkIn(Calendar::NoDay), checkOut(Calendar::NoDay),
+        roomNumber(-1), floor(0), nights(0), finalPrice(0.0) {
     }
 
-    Reservation(int id, int customerId, const string& in, const string& out,
+    Reservation(int id, int customerId, int in, int out,
         int roomNumber, int floor, const string& type,
         int nights, double finalPrice)
         : id(id), customerId(customerId),
@@ -33,11 +35,21 @@ public:
         roomType(type), nights(nights), finalPrice(finalPrice) {
     }
 
+    // Dates as "YYYY-MM-DD" text (files and console input)
+    Reservation(int id, int customerId, const string& in, const string& out,
+        int roomNumber, int floor, const string& type,
+        int nights, double finalPrice)
+        : Reservation(id, customerId, Calendar::parseDay(in), Calendar::parseDay(out),
+            roomNumber, floor, type, nights, finalPrice) {
+    }
+
     
     int getId() const { return id; }
     int getCustomerId() const { return customerId; }
-    const string& getCheckIn() const { return checkIn; }
-    const string& getCheckOut() const { return checkOut; }
+    int getCheckInDay() const { return checkIn; }
+    int getCheckOutDay() const { return checkOut; }
+    string getCheckIn() const { return Calendar::fromDay(checkIn); }
+    string getCheckOut() const { return Calendar::fromDay(checkOut); }
     int getRoomNumber() const { return roomNumber; }
     int getFloor() const { return floor; }
     const string& getRoomType() const { return roomType; }
@@ -45,19 +57,20 @@ public:
     double getFinalPrice() const { return finalPrice; }
 
     void setRoomNumber(int rn) { roomNumber = rn; }
+    void setRoomType(const string& t) { roomType = t; }
 
     void setFinalPrice(double p) { finalPrice = p; }
 
     bool overlaps(const Reservation& other) const {
-        return !(checkOut <= other.getCheckIn() || other.getCheckOut() <= checkIn);
+        return checkIn < other.checkOut && other.checkIn < checkOut;
     }
 
     json to_json() const {
         return json{
             {"id", id},
             {"customerId", customerId},
-            {"checkIn", checkIn},
-            {"checkOut", checkOut},
+            {"checkIn", getCheckIn()},
+            {"checkOut", getCheckOut()},
             {"roomNumber", roomNumber},
             {"floor", floor},
             {"roomType", roomType},
@@ -66,12 +79,27 @@ public:
         };
     }
 
+    // No-DOM twin of to_json, keys sorted like the dump of a json object
+    void write_json(JsonWriter& w) const {
+        w.beginObject();
+        w.field("checkIn", getCheckIn());
+        w.field("checkOut", getCheckOut());
+        w.field("customerId", customerId);
+        w.field("finalPrice", finalPrice);
+        w.field("floor", floor);
+        w.field("id", id);
+        w.field("nights", nights);
+        w.field("roomNumber", roomNumber);
+        w.field("roomType", roomType);
+        w.endObject();
+    }
+
     static Reservation from_json(const json& j) {
         return Reservation(
             j.at("id"),
             j.at("customerId"),
-            j.at("checkIn"),
-            j.at("checkOut"),
+            j.at("checkIn").get<string>(),
+            j.at("checkOut").get<string>(),
             j.at("roomNumber"),
             j.at("floor"),
             j.at("roomType"),
@@ -0,0 +1,74 @@
+#ifndef RESERVATIONARCHIVE_H
+#define RESERVATIONARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "Reservation.h"
+
+using namespace std;
+
+// Append-only archive of completed stays (cold tier). Reservations are
+// moved here once they are old enough, so the working set only holds
+// current and future stays. The file is a sequence of blocks:
+//
+//   header  : magic "HTLA" | u32 count | u32 payloadSize | i32 maxId
+//             | i32 minCustomerId | i32 maxCustomerId | u64 checksum
+//   payload : <count> records sorted by id, delta + varint encoded
+//             (ids and check-in days as deltas, stay length, cents)
+//
+// Blocks are never rewritten. A torn block at the end of the file is
+// ignored when reading and cut off before the next append, so later
+// blocks are not stored behind it; an id archived twice (if the program
+// stopped between appending a block and the checkpoint that followed)
+// is read once.
+class ReservationArchive {
+public:
+    static const size_t BlockHeaderSize = 32;
+
+    struct BlockHeader {
+        uint32_t count = 0;
+        uint32_t payloadSize = 0;
+        int maxId = 0;
+        int minCustomerId = 0;
+        int maxCustomerId = 0;
+        uint64_t checksum = 0;
+    };
+
+private:
+    string path;
+
+public:
+    explicit ReservationArchive(const string& path) : path(path) {}
+
+    const string& getPath() const { return path; }
+
+    // Only reservations with valid dates can be archived
+    static bool isArchivable(const Reservation& r);
+
+    // Encode one block (runs on the persistence thread)
+    static string encodeBlock(vector<Reservation> reservations);
+
+    // Size of the file up to the end of the last block that passes its
+    // checksum (reads every block)
+    size_t validLength() const;
+
+    // Cuts off a torn tail, then appends the encoded block and fsyncs it
+    bool append(const string& block) const;
+
+    // Visit the archived reservations of every block that wantBlock
+    // accepts; rejected blocks are skipped without being decoded
+    void forEach(const function<bool(const BlockHeader&)>& wantBlock,
+        const function<void(const Reservation&)>& visit) const;
+
+    void forEach(const function<void(const Reservation&)>& visit) const;
+    void forCustomer(int customerId, const function<void(const Reservation&)>& visit) const;
+    bool hasCustomer(int customerId) const;
+
+    // Highest archived reservation ID, read from the block headers only
+    int maxId() const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef RESERVATIONSHARDS_H
+#define RESERVATIONSHARDS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Calendar.h"
+
+using namespace std;
+
+// One month of reservations, as listed in the manifest
+struct ReservationShard {
+    string month;          // check-in month, "YYYY-MM", or "undated"
+    uint32_t count = 0;
+    int maxId = 0;
+};
+
+// Reservations are persisted as one binary snapshot per check-in month
+// (<dir>/YYYY-MM.bin) plus a small text manifest naming the non-empty
+// shards, so a checkpoint only rewrites the months that changed.
+//
+// Reservations whose check-in date did not parse go to the "undated"
+// shard instead of being dropped.
+//
+// Manifest format: a "HTLM 1" header line, then "YYYY-MM count maxId"
+// per shard, sorted by month.
+class ReservationShards {
+public:
+    static constexpr const char* Undated = "undated";
+
+    static string monthOf(const string& date) { return date.size() < 3 ? Undated : date.substr(0, date.size() - 3); }
+    static string monthOf(int day) { return day == Calendar::NoDay ? Undated : monthOf(Calendar::fromDay(day)); }
+
+    // "YYYY-MM" (years outside 0000-9999 have more or fewer digits) or "undated"
+    static bool isMonth(const string& month);
+
+    static string shardPath(const string& dir, const string& month) { return dir + "/" + month + ".bin"; }
+    static string manifestPath(const string& dir) { return dir + "/manifest.txt"; }
+
+    // Returns false if the manifest is missing or malformed; error says why
+    static bool readManifest(const string& dir, vector<ReservationShard>& out, string& error);
+
+    // Months of the shard files in dir (to rebuild a damaged manifest)
+    static vector<string> listShards(const string& dir);
+    static string encodeManifest(const vector<ReservationShard>& shards);
+};
+
+#endif
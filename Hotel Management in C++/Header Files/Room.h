@@ -3,7 +3,9 @@
 
 #include <vector>
 #include <string>
+#include <algorithm>
 #include "json.hpp"
+#include "JsonWriter.h"
 
 using namespace std;
 using json = nlohmann::json;
@@ -38,6 +40,12 @@ public:
         reservationIds.push_back(reservationId);
     }
 
+    void removeReservation(int reservationId) {
+        reservationIds.erase(
+            remove(reservationIds.begin(), reservationIds.end(), reservationId),
+            reservationIds.end());
+    }
+
     void clearReservations() {
         reservationIds.clear();
     }
@@ -62,6 +70,29 @@ public:
         };
     }
 
+    // Writes the room without building a json object; keys in sorted
+    // order, as json::dump prints them
+    void write_json(JsonWriter& w) const {
+        w.beginObject();
+
+        w.key("comments");
+        w.beginArray();
+        for (auto& c : comments) w.value(c);
+        w.endArray();
+
+        w.field("floor", floor);
+        w.field("price", price);
+
+        w.key("reservationIds");
+        w.beginArray();
+        for (int id : reservationIds) w.value(id);
+        w.endArray();
+
+        w.field("roomNumber", roomNumber);
+        w.field("type", type);
+        w.endObject();
+    }
+
     static Room from_json(const json& j) {
         Room r(
             j.at("roomNumber").get<int>(),
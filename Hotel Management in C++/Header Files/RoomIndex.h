@@ -0,0 +1,43 @@
+#ifndef ROOMINDEX_H
+#define ROOMINDEX_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "Room.h"
+
+using namespace std;
+
+// Direct index from room number to slot in the rooms vector.
+//
+// Room numbers follow floor * 100 + n, so a number is split into a
+// bucket (number / 100) and an offset (number % 100): a lookup is two
+// array reads, no hashing and no scan. Buckets are only allocated for
+// floors that have rooms. Layouts with more than 100 rooms per floor
+// simply use more buckets; numbers outside [0, MaxDirect) go to a small
+// overflow hash map.
+class RoomIndex {
+private:
+    static const int BucketWidth = 100;
+    static const int MaxDirect = 1 << 20;
+
+    vector<vector<int>> buckets;       // [number / 100][number % 100] -> slot, -1 if none
+    unordered_map<int, int> overflow;
+
+public:
+    void build(const vector<Room>& rooms);
+
+    // Slot of the room in the vector the index was built from, -1 if unknown
+    int find(int roomNumber) const {
+        if (roomNumber >= 0 && roomNumber < MaxDirect) {
+            size_t bucket = static_cast<size_t>(roomNumber / BucketWidth);
+            if (bucket >= buckets.size() || buckets[bucket].empty()) return -1;
+            return buckets[bucket][roomNumber % BucketWidth];
+        }
+
+        auto it = overflow.find(roomNumber);
+        return it == overflow.end() ? -1 : it->second;
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef SAXLOADER_H
+#define SAXLOADER_H
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "json.hpp"
+
+#include "Customer.h"
+#include "Reservation.h"
+#include "Room.h"
+
+using namespace std;
+using json = nlohmann::json;
+
+// Fields of one element of a top-level JSON array, filled token by token.
+// The same record is cleared and reused for every element of the file.
+struct SaxRecord {
+    unordered_map<string, long long> ints;
+    unordered_map<string, double> doubles;
+    unordered_map<string, string> strings;
+    unordered_map<string, vector<long long>> intLists;
+    unordered_map<string, vector<string>> stringLists;
+
+    void clear();
+
+    // Required fields throw out_of_range when missing (like json::at)
+    int getInt(const string& key) const;
+    const string& getString(const string& key) const;
+    double getDouble(const string& key) const;
+
+    // Optional fields (like json::value)
+    int getInt(const string& key, int def) const;
+    double getDouble(const string& key, double def) const;
+};
+
+// SAX handler for files shaped as [ {flat object}, {flat object}, ... ].
+// Arrays of scalars inside an element are collected into the list maps;
+// anything nested deeper is skipped.
+class RecordSax : public nlohmann::json_sax<json> {
+private:
+    function<void(const SaxRecord&)> onRecord;
+    SaxRecord record;
+    string_t currentKey;
+    int depth = 0;
+    bool inList = false;
+
+    void setInt(long long v);
+    void setDouble(double v);
+
+public:
+    explicit RecordSax(function<void(const SaxRecord&)> onRecord)
+        : onRecord(std::move(onRecord)) {
+    }
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+        const nlohmann::detail::exception& ex) override;
+};
+
+// ==========================================================
+// STREAMING LOADERS (no intermediate json DOM)
+// ==========================================================
+// Fast torn-file check: the first and last non-blank bytes of the file
+// must be '[' and ']'. Only the two ends of the file are read.
+bool isCompleteJSONArray(const string& path);
+
+// Each returns false if the stream is not a valid array of records, and
+// then leaves out as it was (no partial list).
+bool loadCustomersSax(istream& in, vector<Customer>& out);
+bool loadReservationsSax(istream& in, vector<Reservation>& out);
+bool loadRoomsSax(istream& in, vector<Room>& out);
+
+// Same loaders for a file already in memory, in any format json.hpp can
+// parse (JSON text, CBOR, MessagePack)
+using input_format = nlohmann::detail::input_format_t;
+bool loadCustomersSax(const string& bytes, input_format format, vector<Customer>& out);
+bool loadReservationsSax(const string& bytes, input_format format, vector<Reservation>& out);
+bool loadRoomsSax(const string& bytes, input_format format, vector<Room>& out);
+
+#endif
@@ -2,15 +2,112 @@
 #define SCHEDULER_H
 
 #include <vector>
+#include <climits>
+#include <chrono>
 #include "Reservation.h"
 #include "Room.h"
+#include "Calendar.h"
 
 using namespace std;
 
 class Scheduler {
 public:
-    // Assigns reservations to existing hotel rooms (no room creation)
-    static void allocateRooms(vector<Reservation>& reservations, vector<Room>& rooms);
+    // [checkIn, checkOut) in day numbers
+    struct Stay {
+        int checkIn;
+        int checkOut;
+    };
+
+    // Planned change of room for one reservation (room numbers, -1 = none)
+    struct RoomMove {
+        int reservationId;
+        int fromRoom;
+        int toRoom;
+    };
+
+    // Room of a type that has never been used by a stay
+    static constexpr int Unused = INT_MIN;
+
+    // Gaps of fewer nights than this between two stays of a room are hard
+    // to sell: their nights count as stranded
+    static constexpr int SellableGap = 3;
+
+    // Stranded nights of the gap [from, to) (from = Unused: no stay
+    // before, to = INT_MAX: no stay after)
+    static int strandedNights(int from, int to) {
+        if (from == Unused || to == INT_MAX) return 0;
+        int gap = to - from;
+        return gap > 0 && gap < SellableGap ? gap : 0;
+    }
+
+    // Interval partitioning of stays onto rooms: stays in check-in order,
+    // each one takes its preferred room if that is free, else the room
+    // that freed up first, else the next unused room. releaseDays[r] is
+    // the day room r becomes free (Unused if it has no stay yet).
+    // Returns the room index of each stay, -1 where every room is taken.
+    // O(n log r); as long as the peak overlap fits the free rooms no stay
+    // is left out. preferred may be empty (no preference).
+    static vector<int> partition(const vector<Stay>& stays, const vector<int>& releaseDays,
+        const vector<int>& preferred);
+
+    // Below this many reservations the scheduler stays on the calling thread
+    static constexpr size_t ParallelThreshold = 20000;
+
+    // Dry run of a full re-plan: the room number of each reservation
+    // afterwards (-1 = not placed); nothing is modified. Each room type,
+    // and within a type each group of overlapping stays, is planned on
+    // its own (on worker threads for large inputs; the result is the same
+    // either way). Stays that checked in before pinBefore keep their
+    // room, the others keep theirs when possible.
+    static vector<int> planRooms(const vector<Reservation>& reservations, const vector<Room>& rooms,
+        int pinBefore = Calendar::NoDay);
+
+    // The same plan as the reservations whose room would change
+    static vector<RoomMove> planMoves(const vector<Reservation>& reservations, const vector<Room>& rooms,
+        int pinBefore = Calendar::NoDay);
+
+    // Reservations whose room differs in planned (room numbers)
+    static vector<RoomMove> movesTo(const vector<Reservation>& reservations, const vector<int>& planned);
+
+    // Stranded nights of the same stays under three plans
+    struct CompactReport {
+        long long firstFit = 0;     // each stay in the first free room, in check-in order
+        long long current = 0;      // the rooms as they are
+        long long compact = 0;      // planCompact
+        size_t swaps = 0;           // tail swaps made by the search
+        bool budgetUsedUp = false;  // the search was stopped by the budget
+    };
+
+    // Optimizing mode: room numbers (like planRooms) for a plan with as
+    // few stranded nights as possible. Best fit first (the free room whose
+    // last stay ended closest to the check-in, avoiding short gaps), then
+    // tail swaps: two rooms exchange everything after a gap when that
+    // closes short gaps, until no swap helps or the budget runs out.
+    // Stays that checked in before pinBefore keep their room. The current
+    // room breaks ties in both steps, and a type keeps its current rooms
+    // unless the plan strands strictly fewer nights (or places more stays).
+    static vector<int> planCompact(const vector<Reservation>& reservations, const vector<Room>& rooms,
+        int pinBefore, chrono::milliseconds budget, CompactReport& report);
+
+private:
+    // Rooms and movable stays of one room type
+    struct TypePlan {
+        vector<int> rooms;          // slots in rooms
+        vector<int> releaseDays;    // per room, from the pinned stays
+        vector<int> movable;        // positions in reservations, by check-in
+    };
+
+    struct Grouping {
+        vector<TypePlan> types;
+        vector<int> typeOf;         // per reservation, -1 = no room of its type
+        vector<int> currentRoom;    // per reservation, room within its type (-1 = none)
+        vector<int> assignedRoom;   // per reservation, planned room within its type
+    };
+
+    // Pinned stays are assigned to their current room
+    static Grouping group(const vector<Reservation>& reservations, const vector<Room>& rooms,
+        int pinBefore);
+    static vector<int> roomNumbers(const Grouping& grouping, const vector<Room>& rooms);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,149 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+using namespace std;
+
+// Dense storage with stable generational handles.
+//
+// Values live contiguously in insertion order (until an erase), so
+// iteration is a plain vector walk. A Handle names a slot; the slot
+// knows where its value currently sits in the dense vector. Erase is
+// swap-and-pop: the last value moves into the hole and only its slot is
+// updated. Erasing bumps the slot's generation, so stale handles stop
+// resolving instead of pointing at another value.
+template <class T>
+class SlotMap {
+public:
+    struct Handle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+private:
+    struct Slot {
+        uint32_t dense = 0;
+        uint32_t generation = 0;
+    };
+
+    vector<T> items;              // dense values
+    vector<uint32_t> owners;      // dense position -> slot
+    vector<Slot> slots;
+    vector<uint32_t> freeSlots;
+
+public:
+    using iterator = typename vector<T>::iterator;
+    using const_iterator = typename vector<T>::const_iterator;
+
+    Handle insert(T value) {
+        uint32_t s;
+        if (!freeSlots.empty()) {
+            s = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            s = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot());
+        }
+
+        slots[s].dense = static_cast<uint32_t>(items.size());
+        items.push_back(std::move(value));
+        owners.push_back(s);
+        return { s, slots[s].generation };
+    }
+
+    bool contains(Handle h) const {
+        return h.index < slots.size() && slots[h.index].generation == h.generation;
+    }
+
+    T* get(Handle h) { return contains(h) ? &items[slots[h.index].dense] : nullptr; }
+    const T* get(Handle h) const { return contains(h) ? &items[slots[h.index].dense] : nullptr; }
+
+    // Swap-and-pop; returns false for a stale handle
+    bool erase(Handle h) {
+        if (!contains(h)) return false;
+
+        uint32_t hole = slots[h.index].dense;
+        uint32_t last = static_cast<uint32_t>(items.size() - 1);
+        if (hole != last) {
+            items[hole] = std::move(items[last]);
+            owners[hole] = owners[last];
+            slots[owners[hole]].dense = hole;
+        }
+
+        items.pop_back();
+        owners.pop_back();
+        slots[h.index].generation++;
+        freeSlots.push_back(h.index);
+        return true;
+    }
+
+    // Handle of the value at a dense position (for rebuilding indexes)
+    Handle handleAt(size_t dense) const {
+        uint32_t s = owners[dense];
+        return { s, slots[s].generation };
+    }
+
+    // Drops every value; all outstanding handles become stale
+    void clear() {
+        items.clear();
+        owners.clear();
+        freeSlots.clear();
+        for (uint32_t s = static_cast<uint32_t>(slots.size()); s-- > 0;) {
+            slots[s].generation++;
+            freeSlots.push_back(s);
+        }
+    }
+
+    // Replace the contents (handles of the old contents become stale)
+    void assign(vector<T> values) {
+        clear();
+        reserve(values.size());
+        for (auto& v : values) insert(std::move(v));
+    }
+
+    // Reorders the dense values; handles stay valid
+    template <class Compare>
+    void sort(Compare less) {
+        vector<uint32_t> order(items.size());
+        iota(order.begin(), order.end(), 0u);
+        stable_sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t b) { return less(items[a], items[b]); });
+
+        vector<T> sorted;
+        vector<uint32_t> sortedOwners;
+        sorted.reserve(items.size());
+        sortedOwners.reserve(items.size());
+        for (uint32_t d : order) {
+            slots[owners[d]].dense = static_cast<uint32_t>(sorted.size());
+            sorted.push_back(std::move(items[d]));
+            sortedOwners.push_back(owners[d]);
+        }
+
+        items.swap(sorted);
+        owners.swap(sortedOwners);
+    }
+
+    void reserve(size_t n) {
+        items.reserve(n);
+        owners.reserve(n);
+    }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    // Dense values (read-only: use handles to keep track of a value)
+    const vector<T>& values() const { return items; }
+
+    // Elements may be modified in place, but not added or removed
+    iterator begin() { return items.begin(); }
+    iterator end() { return items.end(); }
+    const_iterator begin() const { return items.begin(); }
+    const_iterator end() const { return items.end(); }
+};
+
+#endif
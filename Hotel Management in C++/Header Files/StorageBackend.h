@@ -0,0 +1,49 @@
+#ifndef STORAGEBACKEND_H
+#define STORAGEBACKEND_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Customer.h"
+#include "Reservation.h"
+#include "Room.h"
+#include "BinaryStore.h"
+
+using namespace std;
+
+// Snapshot format written by the checkpoints and read by loadData(),
+// selected at startup with --storage=NAME:
+//
+//   binary  : BinaryStore envelope (default; reservations are sharded
+//             by month and memory-mapped)
+//   json    : pretty-printed JSON text (the export format)
+//   cbor    : json.hpp CBOR encoding of the same records
+//   msgpack : json.hpp MessagePack encoding of the same records
+//
+// Backends are stateless; encoders run on the persistence thread.
+class StorageBackend {
+public:
+    virtual ~StorageBackend() = default;
+
+    virtual string name() const = 0;
+    virtual string extension() const = 0;   // ".bin", ".json", ...
+
+    virtual string encodeCustomers(const vector<Customer>& customers) const = 0;
+    virtual string encodeReservations(const vector<Reservation>& reservations) const = 0;
+    virtual string encodeRooms(const vector<Room>& rooms) const = 0;
+
+    // Decoders append to out and return false on malformed input
+    virtual bool decodeCustomers(const string& bytes, vector<Customer>& out) const = 0;
+    virtual bool decodeReservations(const string& bytes, vector<Reservation>& out) const = 0;
+    virtual bool decodeRooms(const string& bytes, vector<Room>& out) const = 0;
+
+    // Cheap torn-file check before the file is read and decoded
+    virtual bool isComplete(const string& path, BinaryStore::Kind kind) const = 0;
+
+    // nullptr for an unknown name
+    static shared_ptr<const StorageBackend> create(const string& name);
+    static vector<string> names();
+};
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef STORAGEBENCHMARK_H
+#define STORAGEBENCHMARK_H
+
+#include <cstddef>
+
+using namespace std;
+
+// Compares the storage backends on synthetic data: save time (encode +
+// atomic write), load time (read + decode) and file size of the three
+// snapshot files. Run with --benchmark; writes scratch files named
+// bench_*.<ext> in the working directory and removes them afterwards.
+class StorageBenchmark {
+public:
+    static void run(size_t customerCount = 10000, size_t reservationCount = 100000, int rounds = 3);
+};
+
+#endif